@@ -0,0 +1,214 @@
+#include "arena.h"
+#include <stdbool.h>
+#include <string.h>
+
+/* Przyjęty przeze mnie rozmiar pierwszej porcji areny. Kolejne porcje
+ * są dwukrotnie większe, aż do rozmiaru max_chunk.
+ */
+const size_t init_chunk = 16 * 1024;
+const size_t max_chunk = 4 * 1024 * 1024;
+
+/**
+ * Wyrównanie pamięci przydzielanej przez arenę.
+ */
+#define ALIGNMENT _Alignof(max_align_t)
+
+/**
+ * Porcja pamięci pobrana od systemu. Za nagłówkiem leżą kolejne bloki.
+ */
+struct chunk {
+    /*@{*/
+    struct chunk *next; /**< następna porcja */
+    size_t size; /**< liczba bajtów na bloki */
+    size_t used; /**< liczba bajtów zajętych przez bloki */
+    /*@{*/
+};
+
+/**
+ * Nagłówek bloku pamięci przydzielonego przez arenę.
+ */
+struct block {
+    /*@{*/
+    size_t size; /**< rozmiar pamięci bloku */
+    struct block *next; /**< następny wolny blok (dla zwolnionych) */
+    /*@{*/
+};
+
+/** @brief Zaokrągla rozmiar w górę do wielokrotności wyrównania.
+ * @param[in] size - rozmiar
+ * @return zaokrąglony rozmiar
+ */
+static inline size_t round_up(size_t size) {
+    return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+/**
+ * Rozmiar nagłówka porcji, zachowujący wyrównanie.
+ */
+#define CHUNK_HEADER round_up(sizeof(struct chunk))
+
+/**
+ * Rozmiar nagłówka bloku, zachowujący wyrównanie.
+ */
+#define BLOCK_HEADER round_up(sizeof(struct block))
+
+/**
+ * Największy rozmiar alokacji, dla którego rozmiar porcji się nie przepełni.
+ */
+#define MAX_SIZE (SIZE_MAX / 2 - CHUNK_HEADER - BLOCK_HEADER)
+
+/** @brief Podaje początek pamięci na bloki porcji.
+ * @param[in] c - porcja
+ * @return wskaźnik na pierwszy bajt za nagłówkiem porcji
+ */
+static inline char *chunk_data(struct chunk *c) {
+    return (char *) c + CHUNK_HEADER;
+}
+
+/** @brief Podaje pamięć bloku.
+ * @param[in] b - nagłówek bloku
+ * @return wskaźnik na pierwszy bajt za nagłówkiem bloku
+ */
+static inline void *payload(struct block *b) {
+    return (char *) b + BLOCK_HEADER;
+}
+
+/** @brief Podaje nagłówek bloku.
+ * @param[in] p - pamięć bloku
+ * @return nagłówek bloku
+ */
+static inline struct block *block_of(void *p) {
+    return (struct block *) ((char *) p - BLOCK_HEADER);
+}
+
+/** @brief Pobiera od systemu nową, pustą porcję.
+ * @param[in] size - liczba bajtów na bloki
+ * @return nowa porcja lub NULL, jeśli nie udało się zaalokować pamięci
+ */
+static struct chunk *new_chunk(size_t size) {
+    struct chunk *c = malloc(CHUNK_HEADER + size);
+    if (c == NULL) { return NULL; }
+    c->next = NULL;
+    c->size = size;
+    c->used = 0;
+    return c;
+}
+
+/** @brief Wydziela blok z wolnej pamięci porcji.
+ * @param[in, out] c - porcja, w której jest miejsce na blok
+ * @param[in] size - zaokrąglony rozmiar pamięci bloku
+ * @return pamięć bloku
+ */
+static void *carve(struct chunk *c, size_t size) {
+    struct block *b = (struct block *) (chunk_data(c) + c->used);
+    b->size = size;
+    c->used += BLOCK_HEADER + size;
+    return payload(b);
+}
+
+/** @brief Sprawdza, czy blok leży na końcu zajętej pamięci bieżącej porcji.
+ * @param[in] a - wskaźnik na arenę
+ * @param[in] b - nagłówek bloku
+ * @return wartość @p true, jeśli blok jest ostatnim blokiem bieżącej
+ * porcji, @p false w przeciwnym wypadku
+ */
+static inline bool is_last(const Arena *a, struct block *b) {
+    struct chunk *c = a->chunks;
+    return c != NULL &&
+           (char *) payload(b) + b->size == chunk_data(c) + c->used;
+}
+
+Arena new_Arena() {
+    Arena a;
+    a.chunks = NULL;
+    a.free_blocks = NULL;
+    a.chunk_size = init_chunk;
+    return a;
+}
+
+void del_Arena(Arena *a) {
+    while (a->chunks != NULL) {
+        struct chunk *next = a->chunks->next;
+        free(a->chunks);
+        a->chunks = next;
+    }
+    *a = new_Arena();
+}
+
+void *arena_allocate(void *data, size_t size) {
+    Arena *a = data;
+    if (size > MAX_SIZE) { return NULL; }
+    size = round_up(size == 0 ? 1 : size);
+    /* Zwolniony blok przydzielamy ponownie, jeśli jest co najwyżej
+     * dwukrotnie większy od potrzebnego - tablice powiększane dwukrotnie
+     * i pamięć zwalniana po każdej rozgrywce wracają w podobnym rozmiarze.
+     */
+    for (struct block **b = &a->free_blocks; *b != NULL; b = &(*b)->next) {
+        if ((*b)->size >= size && (*b)->size / 2 <= size) {
+            struct block *found = *b;
+            *b = found->next;
+            return payload(found);
+        }
+    }
+    struct chunk *c = a->chunks;
+    size_t needed = BLOCK_HEADER + size;
+    if (c != NULL && c->size - c->used >= needed) { return carve(c, size); }
+    if (needed > a->chunk_size / 4) {
+        // Własna porcja jest od razu pełna, więc nie staje się bieżącą.
+        struct chunk *own = new_chunk(needed);
+        if (own == NULL) { return NULL; }
+        if (c == NULL) { a->chunks = own; }
+        else {
+            own->next = c->next;
+            c->next = own;
+        }
+        return carve(own, size);
+    }
+    struct chunk *fresh = new_chunk(a->chunk_size);
+    if (fresh == NULL) { return NULL; }
+    fresh->next = c;
+    a->chunks = fresh;
+    if (a->chunk_size < max_chunk) { a->chunk_size *= 2; }
+    return carve(fresh, size);
+}
+
+void *arena_reallocate(void *data, void *p, size_t size) {
+    Arena *a = data;
+    if (p == NULL) { return arena_allocate(a, size); }
+    struct block *b = block_of(p);
+    if (size <= b->size) { return p; }
+    if (size > MAX_SIZE) { return NULL; }
+    size_t grow = round_up(size) - b->size;
+    struct chunk *c = a->chunks;
+    if (is_last(a, b) && c->size - c->used >= grow) {
+        c->used += grow;
+        b->size += grow;
+        return p;
+    }
+    void *q = arena_allocate(a, size);
+    if (q == NULL) { return NULL; }
+    memcpy(q, p, b->size);
+    arena_release(a, p);
+    return q;
+}
+
+void arena_release(void *data, void *p) {
+    Arena *a = data;
+    if (p == NULL) { return; }
+    struct block *b = block_of(p);
+    if (is_last(a, b)) {
+        a->chunks->used -= BLOCK_HEADER + b->size;
+        return;
+    }
+    b->next = a->free_blocks;
+    a->free_blocks = b;
+}
+
+Allocator arena_allocator(Arena *a) {
+    Allocator allocator;
+    allocator.allocate = arena_allocate;
+    allocator.reallocate = arena_reallocate;
+    allocator.release = arena_release;
+    allocator.data = a;
+    return allocator;
+}
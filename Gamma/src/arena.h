@@ -0,0 +1,75 @@
+/** @file
+ * Interfejs klasy przechowującej arenę pamięci jednej gry.
+ * Arena pobiera pamięć od systemu dużymi porcjami i przydziela ją
+ * kolejnym alokacjom, przesuwając wskaźnik w bieżącej porcji. Alokacje
+ * większe od ćwiartki porcji dostają własne porcje. Zwolniona pamięć
+ * trafia na listę wolnych bloków i jest przydzielana ponownie alokacjom
+ * podobnego rozmiaru, a ostatni blok bieżącej porcji można zwolnić lub
+ * powiększyć w miejscu. Wszystkie porcje zwalniane są naraz.
+ * Arena nie jest współdzielona między grami, więc nie wymaga blokad.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "malloc.h"
+#include <stddef.h>
+
+/**
+ * Struktura reprezentująca arenę pamięci.
+ */
+struct arena {
+    /*@{*/
+    struct chunk *chunks; /**< lista porcji, na początku bieżąca */
+    struct block *free_blocks; /**< lista zwolnionych bloków */
+    size_t chunk_size; /**< rozmiar następnej zwykłej porcji */
+    /*@{*/
+};
+/**
+ * Typ Arena - alias na strukturę typu arena.
+ */
+typedef struct arena Arena;
+
+/** @brief Tworzy nową, pustą arenę.
+ * Pamięć pobierana jest od systemu dopiero przy pierwszej alokacji.
+ * @return Nowa pusta arena.
+ */
+Arena new_Arena();
+
+/** @brief Zwalnia całą pamięć areny.
+ * Wskaźniki na pamięć przydzieloną przez arenę stają się nieważne.
+ * @param[in, out] a - wskaźnik na arenę
+ */
+void del_Arena(Arena *a);
+
+/** @brief Przydziela pamięć z areny.
+ * @param[in, out] data - wskaźnik na arenę
+ * @param[in] size - rozmiar pamięci
+ * @return wskaźnik na przydzieloną pamięć lub NULL, jeśli nie udało się
+ * zaalokować porcji
+ */
+void *arena_allocate(void *data, size_t size);
+
+/** @brief Zmienia rozmiar pamięci przydzielonej z areny.
+ * @param[in, out] data - wskaźnik na arenę
+ * @param[in] p - wskaźnik na pamięć przydzieloną z areny lub NULL
+ * @param[in] size - nowy rozmiar pamięci
+ * @return wskaźnik na pamięć o nowym rozmiarze, zawierającą dotychczasowe
+ * dane, lub NULL, jeśli nie udało się zaalokować porcji - wtedy pamięć
+ * @p p pozostaje niezmieniona
+ */
+void *arena_reallocate(void *data, void *p, size_t size);
+
+/** @brief Zwraca pamięć do areny.
+ * @param[in, out] data - wskaźnik na arenę
+ * @param[in] p - wskaźnik na pamięć przydzieloną z areny
+ */
+void arena_release(void *data, void *p);
+
+/** @brief Tworzy alokator przydzielający pamięć z areny.
+ * @param[in] a - wskaźnik na arenę, musi istnieć tak długo jak alokator
+ * @return alokator areny
+ */
+Allocator arena_allocator(Arena *a);
+
+#endif //ARENA_H
@@ -0,0 +1,177 @@
+#include "articulation.h"
+#include "malloc.h"
+#include "stats.h"
+
+Articulation new_Articulation(const Allocator *allocator) {
+    Articulation a;
+    a.cuts = empty_Pages(sizeof(struct cut), allocator);
+    a.versions = NULL;
+    a.elements = 0;
+    a.last_version = 0;
+    a.time = 0;
+    a.failed = false;
+    a.allocator = allocator;
+    return a;
+}
+
+void del_Articulation(Articulation *a) {
+    del_Pages(&a->cuts);
+    safe_free(a->allocator, a->versions);
+    *a = new_Articulation(a->allocator);
+}
+
+/** @brief Alokuje katalog stron wartości pól przy pierwszym zapytaniu.
+ * Strony alokowane są dopiero przy pierwszym zapisie do nich.
+ * @param[in, out] a - wskaźnik na strukturę
+ * @param[in] b - plansza gry
+ * @return wartość @p true, jeśli katalog jest zaalokowany, @p false, jeśli
+ * nie udało się zaalokować pamięci
+ */
+static bool reserve_fields(Articulation *a, const Board *b) {
+    if (a->cuts.directory != NULL) { return true; }
+    a->cuts = new_Pages(board_size(b), sizeof(struct cut), a->allocator);
+    if (a->cuts.directory == NULL) {
+        a->failed = true;
+        return false;
+    }
+    return true;
+}
+
+/** @brief Podaje wartości pola, alokując w razie potrzeby ich stronę.
+ * Nowa strona jest wyzerowana - pola wyznaczone przy wersji 0
+ * i odwiedzone w chwili 0 nie istnieją.
+ * @param[in, out] a - wskaźnik na strukturę z zaalokowanym katalogiem
+ * @param[in] f - numer pola
+ * @return wskaźnik na wartości pola lub NULL, jeśli nie udało się
+ * zaalokować strony (błąd zapamiętywany jest w polu @p failed)
+ */
+static inline struct cut *cut_of(Articulation *a, uint64_t f) {
+    struct cut *page = find_page(&a->cuts, f);
+    if (page == NULL) {
+        page = add_page(&a->cuts, f);
+        if (page == NULL) {
+            a->failed = true;
+            return NULL;
+        }
+    }
+    return &page[page_offset(f)];
+}
+
+/** @brief Podaje wersję obszaru o danym reprezentancie.
+ * Elementy utworzone od ostatniego zapytania dostają nowe wersje.
+ * @param[in, out] a - wskaźnik na strukturę
+ * @param[in] u - obszary graczy
+ * @param[in] root - reprezentant obszaru
+ * @return wskaźnik na wersję obszaru lub NULL, jeśli nie udało się
+ * zaalokować pamięci
+ */
+static uint64_t *version(Articulation *a, const UnionFind *u, uint64_t root) {
+    if (root >= a->elements) {
+        uint64_t *versions = safe_realloc(a->allocator, a->versions,
+                                          u->capacity, sizeof(uint64_t));
+        if (versions == NULL) {
+            a->failed = true;
+            return NULL;
+        }
+        a->versions = versions;
+        for (uint64_t i = a->elements; i < u->capacity; i++) {
+            a->versions[i] = ++a->last_version;
+        }
+        a->elements = u->capacity;
+    }
+    return &a->versions[root];
+}
+
+void invalidate_regions(Articulation *a, const Board *b, UnionFind *u,
+                        uint64_t f) {
+    if (a->cuts.directory == NULL) { return; }
+    uint64_t fields[5] = {f};
+    adjacent_fields(b, f, fields + 1);
+    for (int i = 0; i < 5; i++) {
+        uint32_t owner = get_field(b, fields[i]);
+        if (owner == 0 || owner == border_value(b)) { continue; }
+        uint64_t *v = version(a, u, find_field(u, fields[i]));
+        if (v != NULL) { *v = ++a->last_version; }
+    }
+}
+
+/** @brief Wyznacza podziały dla wszystkich pól obszaru.
+ * Przechodzi obszar iteracyjnym DFS-em (algorytm Tarjana). Element stosu
+ * to numer pola pomnożony przez 8 plus numer następnego sąsiada do
+ * sprawdzenia. Po przejrzeniu poddrzewa syna sprawdzamy, czy syn ma
+ * krawędź powrotną ponad ojca - jeśli nie, zabranie ojca odetnie to
+ * poddrzewo od reszty obszaru.
+ * @param[in, out] a - wskaźnik na strukturę
+ * @param[in, out] b - plansza gry
+ * @param[in] start - dowolne pole obszaru
+ * @param[in] stamp - bieżąca wersja obszaru
+ * @return wartość @p true, jeśli wyznaczono wartości całego obszaru,
+ * @p false, jeśli nie udało się zaalokować pamięci
+ */
+static bool compute_region(Articulation *a, Board *b, uint64_t start,
+                           uint64_t stamp) {
+    uint32_t p = get_field(b, start);
+    uint64_t first = a->time + 1;
+    Stack *stack = &b->stacks[0];
+    clear(stack);
+    struct cut *s = cut_of(a, start);
+    if (s == NULL) { return false; }
+    s->order = s->low = ++a->time;
+    s->children = 0;
+    push(stack, start * 8);
+    while (!empty(stack)) {
+        uint64_t top = pop(stack);
+        uint64_t v = top / 8;
+        uint64_t d = top % 8;
+        struct cut *cv = cut_of(a, v);
+        if (cv == NULL) { return false; }
+        if (d < 4) {
+            push(stack, top + 1);
+            uint64_t neighbours[4];
+            adjacent_fields(b, v, neighbours);
+            uint64_t n = neighbours[d];
+            if (get_field(b, n) != p) { continue; }
+            struct cut *cn = cut_of(a, n);
+            if (cn == NULL) { return false; }
+            if (cn->order < first) {
+                cn->order = cn->low = ++a->time;
+                cn->children = 0;
+                push(stack, n * 8);
+            } else if (cn->order < cv->low) {
+                cv->low = cn->order;
+            }
+            continue;
+        }
+        // Pole v przejrzane, ojciec leży teraz na szczycie stosu.
+        COUNT(searched_fields, 1);
+        cv->parts = cv->children + (v != start);
+        cv->stamp = stamp;
+        if (empty(stack)) { continue; }
+        // Strona ojca jest już zaalokowana, bo był odwiedzony.
+        struct cut *cp = cut_of(a, stack->elements[stack->size - 1] / 8);
+        if (cv->low < cp->low) { cp->low = cv->low; }
+        if (cv->low >= cp->order) { cp->children++; }
+    }
+    // Przeszukanie bez pamięci na stos nie odwiedziło całego obszaru.
+    return !stack->failed;
+}
+
+bool split_parts(Articulation *a, Board *b, UnionFind *u, uint64_t f,
+                 uint64_t *parts) {
+    // Małą planszę wystarczy wypełnić od sąsiadów pola.
+    if (has_bitboards(b)) {
+        *parts = bitboard_split_parts(b, f);
+        return true;
+    }
+    if (!reserve_fields(a, b)) { return false; }
+    uint64_t *v = version(a, u, find_field(u, f));
+    if (v == NULL) { return false; }
+    uint64_t stamp = *v;
+    struct cut *c = cut_of(a, f);
+    if (c == NULL) { return false; }
+    if (c->stamp != stamp && !compute_region(a, b, f, stamp)) {
+        return false;
+    }
+    *parts = c->parts;
+    return true;
+}
@@ -0,0 +1,102 @@
+/** @file
+ * Interfejs punktów artykulacji obszarów graczy.
+ * Dla każdego zajętego pola pamiętamy, na ile części rozpadnie się
+ * jego obszar, jeśli pole zostanie zabrane złotym ruchem. Wartości
+ * wyznaczane są algorytmem Tarjana dla całego obszaru naraz, dopiero gdy
+ * są potrzebne, i pozostają ważne, dopóki obszar się nie zmieni.
+ * Każdy element struktury zbiorów rozłącznych, który jest reprezentantem
+ * obszaru, ma znacznik wersji, a wartość pola jest ważna, jeśli została
+ * wyznaczona przy bieżącej wersji jego obszaru. Zmiana pola planszy
+ * nadaje nowe wersje tylko obszarom tego pola i jego sąsiadów, więc
+ * wyniki dla pozostałych obszarów zostają zachowane.
+ * Wartości pól leżą w tablicy podzielonej na strony (patrz @ref pages.h),
+ * więc zajmują pamięć tylko na stronach z polami przeszukanych obszarów,
+ * a nie na całej planszy.
+ * Na planszy ze zbiorami pól graczy podział wyznaczany jest przy każdym
+ * zapytaniu operacjami na zbiorach, więc tablice nie są alokowane.
+ */
+
+#ifndef ARTICULATION_H
+#define ARTICULATION_H
+
+#include "board.h"
+#include "pages.h"
+#include "unionFind.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Wartości jednego pola. Pole, którego strona nie była jeszcze potrzebna,
+ * ma same zera.
+ */
+struct cut {
+    /*@{*/
+    uint64_t stamp; /**< wersja obszaru, przy której wyznaczono pole */
+    uint64_t order; /**< numer odwiedzin pola w algorytmie Tarjana */
+    uint64_t low; /**< najmniejszy numer odwiedzin osiągalny z poddrzewa */
+    uint8_t parts; /**< liczba części obszaru po zabraniu pola */
+    uint8_t children; /**< liczba poddrzew odciętych po zabraniu pola */
+    /*@{*/
+};
+
+/**
+ * Struktura przechowująca wyznaczone podziały obszarów.
+ * Katalog stron wartości pól alokowany jest przy pierwszym zapytaniu.
+ */
+struct articulation {
+    /*@{*/
+    Pages cuts; /**< wartości pól (patrz @ref cut), podzielone na strony */
+    uint64_t *versions; /**< wersje obszarów, indeksowane elementami
+                         * struktury zbiorów rozłącznych */
+    uint64_t elements; /**< liczba elementów, dla których są wersje */
+    uint64_t last_version; /**< ostatnia nadana wersja */
+    uint64_t time; /**< ostatni nadany numer odwiedzin */
+    bool failed; /**< czy nie udało się zaalokować którejś tablicy */
+    const Allocator *allocator; /**< alokator pamięci lub NULL */
+    /*@{*/
+};
+/**
+ * Typ Articulation - alias na struct articulation.
+ */
+typedef struct articulation Articulation;
+
+/** @brief Tworzy strukturę bez wyznaczonych wartości.
+ * @param[in] allocator - alokator pamięci lub NULL (funkcje biblioteki
+ * standardowej), musi istnieć tak długo jak struktura
+ * @return Nowa struktura.
+ */
+Articulation new_Articulation(const Allocator *allocator);
+
+/** @brief Usuwa strukturę.
+ * Zwalnia pamięć zaalokowaną na wszystkie tablice.
+ * @param[in, out] a - wskaźnik na strukturę
+ */
+void del_Articulation(Articulation *a);
+
+/** @brief Unieważnia wartości obszarów, które mogła zmienić zmiana pola.
+ * Nadaje nowe wersje obszarom zawierającym dane pole i jego sąsiadów.
+ * Nic nie robi, jeśli nikt jeszcze nie pytał o podziały obszarów.
+ * @param[in, out] a - wskaźnik na strukturę
+ * @param[in] b - plansza gry po zmianie pola
+ * @param[in, out] u - obszary graczy
+ * @param[in] f - numer zmienionego pola
+ */
+void invalidate_regions(Articulation *a, const Board *b, UnionFind *u,
+                        uint64_t f);
+
+/** @brief Podaje, na ile części rozpadnie się obszar po zabraniu pola.
+ * Jeśli wartość nie jest ważna, wyznacza wartości dla całego obszaru.
+ * @param[in, out] a - wskaźnik na strukturę
+ * @param[in, out] b - plansza gry
+ * @param[in, out] u - obszary graczy
+ * @param[in] f - numer zajętego pola
+ * @param[out] parts - liczba części (od 0 do 4), na które rozpadnie się
+ * obszar pola @p f po jego zabraniu
+ * @return wartość @p true, jeśli liczba części została wyznaczona, @p false,
+ * jeśli nie udało się zaalokować pamięci (błąd zapamiętywany jest w polu
+ * @p failed)
+ */
+bool split_parts(Articulation *a, Board *b, UnionFind *u, uint64_t f,
+                 uint64_t *parts);
+
+#endif //ARTICULATION_H
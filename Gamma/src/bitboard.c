@@ -0,0 +1,68 @@
+#include "bitboard.h"
+
+/** @brief Przesuwa zbiór w stronę wyższych numerów pól.
+ * @param[in] s - zbiór
+ * @param[in] n - przesunięcie, mniejsze od @ref BITBOARD_FIELDS
+ * @return zbiór pól o numerach większych o @p n od pól zbioru @p s
+ */
+static inline Bitboard shift_up(const Bitboard *s, uint64_t n) {
+    Bitboard result;
+    int words = n / 64;
+    int bits = n % 64;
+    for (int i = BITBOARD_WORDS - 1; i >= 0; i--) {
+        uint64_t low = i - words >= 0 ? s->words[i - words] : 0;
+        uint64_t lower = i - words - 1 >= 0 ? s->words[i - words - 1] : 0;
+        result.words[i] = bits == 0 ? low
+                                    : low << bits | lower >> (64 - bits);
+    }
+    return result;
+}
+
+/** @brief Przesuwa zbiór w stronę niższych numerów pól.
+ * @param[in] s - zbiór
+ * @param[in] n - przesunięcie, mniejsze od @ref BITBOARD_FIELDS
+ * @return zbiór pól o numerach mniejszych o @p n od pól zbioru @p s
+ */
+static inline Bitboard shift_down(const Bitboard *s, uint64_t n) {
+    Bitboard result;
+    int words = n / 64;
+    int bits = n % 64;
+    for (int i = 0; i < BITBOARD_WORDS; i++) {
+        uint64_t high = i + words < BITBOARD_WORDS ? s->words[i + words] : 0;
+        uint64_t higher = i + words + 1 < BITBOARD_WORDS
+                          ? s->words[i + words + 1] : 0;
+        result.words[i] = bits == 0 ? high
+                                    : high >> bits | higher << (64 - bits);
+    }
+    return result;
+}
+
+Bitboard bitboard_grow(const Bitboard *s, const Bitboard *mask,
+                       uint64_t stride) {
+    Bitboard up = shift_up(s, stride);
+    Bitboard down = shift_down(s, stride);
+    Bitboard result;
+    for (int i = 0; i < BITBOARD_WORDS; i++) {
+        // Sąsiedzi w wierszu: przesunięcia o jedno pole, z przeniesieniem.
+        uint64_t left = s->words[i] >> 1 |
+                        (i + 1 < BITBOARD_WORDS ? s->words[i + 1] << 63 : 0);
+        uint64_t right = s->words[i] << 1 |
+                         (i > 0 ? s->words[i - 1] >> 63 : 0);
+        result.words[i] = (s->words[i] | left | right |
+                           up.words[i] | down.words[i]) & mask->words[i];
+    }
+    return result;
+}
+
+Bitboard bitboard_flood(Bitboard seed, const Bitboard *mask,
+                        uint64_t stride) {
+    while (true) {
+        Bitboard next = bitboard_grow(&seed, mask, stride);
+        bool same = true;
+        for (int i = 0; i < BITBOARD_WORDS; i++) {
+            if (next.words[i] != seed.words[i]) { same = false; }
+        }
+        if (same) { return seed; }
+        seed = next;
+    }
+}
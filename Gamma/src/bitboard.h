@@ -0,0 +1,111 @@
+/** @file
+ * Interfejs zbiorów pól małej planszy zapisanych w kilku słowach.
+ * Bit o numerze pola planszy (wraz z ramką) oznacza, że pole należy
+ * do zbioru, tak jak w zbiorach z @ref frontier.h. Sąsiedzi pola leżą
+ * o 1 i o szerokość wiersza dalej, więc sąsiadów wszystkich pól zbioru
+ * naraz wyznacza się przesunięciami całego zbioru. Przesunięcie
+ * wychodzące poza wiersz trafia w ramkę, która nie należy do zbiorów
+ * pól graczy ani pól wolnych, więc nie trzeba go maskować.
+ */
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Liczba słów zbioru.
+ */
+#define BITBOARD_WORDS 8
+
+/**
+ * Największa liczba pól planszy (wraz z ramką), dla której zbiory
+ * są przechowywane - np. plansza 20x20.
+ */
+#define BITBOARD_FIELDS (64 * BITBOARD_WORDS)
+
+/**
+ * Struktura przechowująca zbiór pól małej planszy.
+ */
+struct bitboard {
+    /*@{*/
+    uint64_t words[BITBOARD_WORDS]; /**< bity kolejnych pól */
+    /*@{*/
+};
+/**
+ * Typ Bitboard - alias na struct bitboard.
+ */
+typedef struct bitboard Bitboard;
+
+/** @brief Tworzy pusty zbiór.
+ * @return Pusty zbiór.
+ */
+static inline Bitboard empty_bitboard() {
+    Bitboard result;
+    for (int i = 0; i < BITBOARD_WORDS; i++) {
+        result.words[i] = 0;
+    }
+    return result;
+}
+
+/** @brief Dodaje pole do zbioru.
+ * @param[in, out] s - zbiór
+ * @param[in] f - numer pola
+ */
+static inline void bitboard_add(Bitboard *s, uint64_t f) {
+    s->words[f / 64] |= (uint64_t) 1 << (f % 64);
+}
+
+/** @brief Usuwa pole ze zbioru.
+ * @param[in, out] s - zbiór
+ * @param[in] f - numer pola
+ */
+static inline void bitboard_remove(Bitboard *s, uint64_t f) {
+    s->words[f / 64] &= ~((uint64_t) 1 << (f % 64));
+}
+
+/** @brief Sprawdza, czy pole należy do zbioru.
+ * @param[in] s - zbiór
+ * @param[in] f - numer pola
+ * @return wartość @p true, jeśli pole należy do zbioru, @p false
+ * w przeciwnym wypadku
+ */
+static inline bool bitboard_has(const Bitboard *s, uint64_t f) {
+    return (s->words[f / 64] >> (f % 64)) & 1;
+}
+
+/** @brief Liczy pola zbioru.
+ * @param[in] s - zbiór
+ * @return liczba pól zbioru
+ */
+static inline uint64_t bitboard_count(const Bitboard *s) {
+    uint64_t result = 0;
+    for (int i = 0; i < BITBOARD_WORDS; i++) {
+        result += __builtin_popcountll(s->words[i]);
+    }
+    return result;
+}
+
+/** @brief Wyznacza pola zbioru i jego sąsiadów, należące do maski.
+ * @param[in] s - zbiór
+ * @param[in] mask - maska
+ * @param[in] stride - odległość między sąsiednimi wierszami planszy
+ * @return zbiór pól należących do @p mask, które należą do @p s
+ * lub sąsiadują z jego polem
+ */
+Bitboard bitboard_grow(const Bitboard *s, const Bitboard *mask,
+                       uint64_t stride);
+
+/** @brief Wyznacza pola maski połączone z polami zbioru.
+ * Rozszerza zbiór o sąsiadów należących do maski, aż przestanie rosnąć.
+ * @param[in] seed - zbiór pól należących do maski
+ * @param[in] mask - maska
+ * @param[in] stride - odległość między sąsiednimi wierszami planszy
+ * @return zbiór pól maski, do których prowadzi ścieżka pól maski
+ * z któregoś pola zbioru @p seed
+ */
+Bitboard bitboard_flood(Bitboard seed, const Bitboard *mask,
+                        uint64_t stride);
+
+#endif //BITBOARD_H
@@ -1,163 +1,425 @@
 #include "board.h"
 #include "malloc.h"
+#include "printer.h"
+#include "stats.h"
+#include <string.h>
 
-bool has_adjacent(uint32_t **board, uint32_t x, uint32_t y, uint32_t p,
-                  uint32_t width, uint32_t height) {
-    if (x >= height || y >= width) { return false; }
-    bool result = false;
-    if (x > 0 && board[x - 1][y] == p) {
-        result = true;
+/** @brief Rezerwuje nowe wartości znaczników dla przeszukiwania planszy.
+ * Zarezerwowane wartości są większe od wszystkich dotychczas użytych,
+ * więc pole ma znacznik nie mniejszy od pierwszej z nich wtedy i tylko
+ * wtedy, gdy zostało oznaczone w bieżącym przeszukiwaniu. Tablica
+ * znaczników jest zerowana tylko przy pierwszym użyciu i po wyczerpaniu
+ * zakresu wartości.
+ * @param[in, out] b - plansza gry
+ * @param[in] n - liczba potrzebnych wartości
+ * @return pierwsza z zarezerwowanych wartości lub zero, jeśli nie udało się
+ * zaalokować pamięci na znaczniki
+ */
+static uint32_t reserve_marks(Board *b, uint32_t n) {
+    if (is_paged(b)) {
+        if (b->mark_pages.directory == NULL) {
+            b->mark_pages = new_Pages(board_size(b), sizeof(uint32_t),
+                                      b->allocator);
+            if (b->mark_pages.directory == NULL) {
+                b->failed = true;
+                return 0;
+            }
+        }
+        if (b->mark > UINT32_MAX - n) {
+            clear_pages(&b->mark_pages);
+            b->mark = 0;
+        }
+    } else if (b->marks == NULL || b->mark > UINT32_MAX - n) {
+        if (b->marks == NULL) {
+            b->marks = safe_malloc(b->allocator, board_size(b),
+                                   sizeof(uint32_t));
+            if (b->marks == NULL) {
+                b->failed = true;
+                return 0;
+            }
+        }
+        for (uint64_t i = 0; i < board_size(b); i++) {
+            b->marks[i] = 0;
+        }
+        b->mark = 0;
+    }
+    uint32_t first = b->mark + 1;
+    b->mark += n;
+    return first;
+}
+
+/** @brief Odczytuje znacznik pola planszy podzielonej na strony.
+ * @param[in] b - plansza podzielona na strony
+ * @param[in] f - numer pola
+ * @return znacznik pola (0 dla niezaalokowanej strony)
+ */
+static inline uint32_t paged_mark(const Board *b, uint64_t f) {
+    const uint32_t *page = find_page(&b->mark_pages, f);
+    return page != NULL ? page[page_offset(f)] : 0;
+}
+
+/** @brief Zapisuje znacznik pola planszy podzielonej na strony.
+ * Jeśli nie uda się zaalokować strony, zapamiętuje błąd w polu
+ * @p failed planszy, co przerywa przeszukiwanie.
+ * @param[in, out] b - plansza podzielona na strony
+ * @param[in] f - numer pola
+ * @param[in] mark - nowy znacznik
+ */
+static inline void set_paged_mark(Board *b, uint64_t f, uint32_t mark) {
+    uint32_t *page = find_page(&b->mark_pages, f);
+    if (page == NULL) {
+        page = add_page(&b->mark_pages, f);
+        if (page == NULL) {
+            b->failed = true;
+            return;
+        }
+    }
+    page[page_offset(f)] = mark;
+}
+
+void set_paged_field(Board *b, uint64_t f, uint32_t p) {
+    uint32_t *page = find_page(&b->cells, f);
+    if (page == NULL) {
+        page = add_page(&b->cells, f);
+        if (page == NULL) {
+            b->failed = true;
+            return;
+        }
+        // Nowa strona jest wyzerowana, brakuje w niej tylko ramki.
+        uint64_t first = f - page_offset(f);
+        for (uint64_t i = 0; i < PAGE_ELEMENTS; i++) {
+            if (first + i < board_size(b) && on_border(b, first + i)) {
+                page[i] = BORDER;
+            }
+        }
+    } else if (is_shared(&b->cells, page)) {
+        page = copy_page(&b->cells, f);
+        if (page == NULL) {
+            b->failed = true;
+            return;
+        }
     }
-    if (x < height - 1 && board[x + 1][y] == p) {
-        result = true;
+    page[page_offset(f)] = p;
+}
+
+/** @brief Znajduje grupę, z którą połączyła się dana grupa.
+ * @param[in, out] joined - grupy, z którymi połączyły się kolejne grupy
+ * (grupa połączona sama ze sobą reprezentuje swoją część obszaru)
+ * @param[in] i - numer grupy
+ * @return numer grupy reprezentującej część obszaru, do której należy
+ * grupa @p i
+ */
+static int joined_group(int joined[4], int i) {
+    while (joined[i] != i) {
+        i = joined[i];
     }
-    if (y > 0 && board[x][y - 1] == p) {
-        result = true;
+    return i;
+}
+
+/** @brief Liczy przeszukiwane części obszaru.
+ * Przeszukiwania z różnych grup, które się spotkały, należą do jednej
+ * części. Część jest zakończona, jeśli wszystkie jej przeszukiwania
+ * wyczerpały swoje stosy.
+ * @param[in, out] joined - grupy, z którymi połączyły się kolejne grupy
+ * @param[in] stacks - stosy przeszukiwań kolejnych grup
+ * @param[in] n - liczba grup
+ * @param[out] finished - liczba zakończonych części
+ * @return liczba niezakończonych części
+ */
+static int count_parts(int joined[4], Stack stacks[4], int n, int *finished) {
+    bool part[4] = {false, false, false, false};
+    bool active[4] = {false, false, false, false};
+    for (int i = 0; i < n; i++) {
+        int j = joined_group(joined, i);
+        part[j] = true;
+        if (!empty(&stacks[i])) { active[j] = true; }
     }
-    if (y < width - 1 && board[x][y + 1] == p) {
-        result = true;
+    int result = 0;
+    *finished = 0;
+    for (int j = 0; j < n; j++) {
+        if (part[j] && active[j]) { result++; }
+        if (part[j] && !active[j]) { (*finished)++; }
     }
     return result;
 }
 
-uint64_t count_adjacent_free(uint32_t **board, uint32_t x, uint32_t y,
-                             uint32_t p, uint32_t width, uint32_t height) {
-    if (x >= height || y >= width) { return 0; }
-    uint64_t result = 0;
-    if (x > 0 && board[x - 1][y] == 0) {
-        if (!has_adjacent(board, x - 1, y, p, width, height)) {
-            result++;
-        }
-    }
-    if (x < height - 1 && board[x + 1][y] == 0) {
-        if (!has_adjacent(board, x + 1, y, p, width, height)) {
-            result++;
+/* Wersje funkcji przeglądających planszę dla każdej szerokości pola. */
+#define CELL uint8_t
+#define SUFFIX(name) name##_8
+#include "boardTemplate.h"
+#undef CELL
+#undef SUFFIX
+
+#define CELL uint16_t
+#define SUFFIX(name) name##_16
+#include "boardTemplate.h"
+#undef CELL
+#undef SUFFIX
+
+#define CELL uint32_t
+#define SUFFIX(name) name##_32
+#include "boardTemplate.h"
+#undef CELL
+#undef SUFFIX
+
+/* Wersja dla planszy podzielonej na strony. */
+#define CELL uint32_t
+#define SUFFIX(name) name##_paged
+#define PAGED
+#include "boardTemplate.h"
+#undef CELL
+#undef SUFFIX
+#undef PAGED
+
+/**
+ * Wywołuje wersję funkcji @p name odpowiednią dla szerokości pól planszy
+ * lub dla planszy podzielonej na strony.
+ */
+#define BY_CELL_SIZE(b, name, ...) \
+    (is_paged(b) ? name##_paged(__VA_ARGS__) : \
+     (b)->cell_size == sizeof(uint8_t) ? name##_8(__VA_ARGS__) : \
+     (b)->cell_size == sizeof(uint16_t) ? name##_16(__VA_ARGS__) : \
+     name##_32(__VA_ARGS__))
+
+/** @brief Dzieli obszar na części, wypełniając go ze zbiorów pól.
+ * Wypełnia maskę z kolejnych pól startowych, pomijając pola należące
+ * już do znalezionej części.
+ * @param[in] b - plansza gry ze zbiorami pól graczy
+ * @param[in] mask - pola obszaru po zabraniu pola
+ * @param[in] sources - pola startowe z różnych grup lokalnych
+ * @param[in] n - liczba pól startowych
+ * @param[out] parts - pola kolejnych części
+ * @return liczba części
+ */
+static int bitboard_parts(const Board *b, const Bitboard *mask,
+                          const uint64_t sources[4], int n,
+                          Bitboard parts[4]) {
+    int result = 0;
+    for (int i = 0; i < n; i++) {
+        bool found = false;
+        for (int j = 0; j < result && !found; j++) {
+            found = bitboard_has(&parts[j], sources[i]);
         }
+        if (found) { continue; }
+        Bitboard seed = empty_bitboard();
+        bitboard_add(&seed, sources[i]);
+        parts[result] = bitboard_flood(seed, mask, b->stride);
+        COUNT(searched_fields, bitboard_count(&parts[result]));
+        result++;
     }
-    if (y > 0 && board[x][y - 1] == 0) {
-        if (!has_adjacent(board, x, y - 1, p, width, height)) {
-            result++;
+    return result;
+}
+
+/** @brief Dzieli obszar gracza po zabraniu pola, korzystając ze zbiorów pól.
+ * Największa część zostaje przy starym zbiorze, pozostałe dostają nowe.
+ * @param[in] b - plansza gry ze zbiorami pól graczy
+ * @param[in, out] u - struktura zbiorów rozłącznych
+ * @param[in] f - numer pola, które jest już puste
+ * @param[in] p - numer gracza, do którego należało pole
+ * @param[in] max_parts - największa liczba części, przy której obszar
+ * jest dzielony
+ * @return liczba części
+ */
+static uint64_t bitboard_split(const Board *b, UnionFind *u, uint64_t f,
+                               uint32_t p, uint64_t max_parts) {
+    uint64_t sources[4];
+    int n = local_groups_8(b, f, p, sources);
+    if (n <= 1) { return n; }
+    COUNT(area_splits, 1);
+    Bitboard parts[4];
+    int count = bitboard_parts(b, &b->owned[p], sources, n, parts);
+    if (count == 1 || (uint64_t) count > max_parts) { return count; }
+    int largest = 0;
+    for (int i = 1; i < count; i++) {
+        if (bitboard_count(&parts[i]) > bitboard_count(&parts[largest])) {
+            largest = i;
         }
     }
-    if (y < width - 1 && board[x][y + 1] == 0) {
-        if (!has_adjacent(board, x, y + 1, p, width, height)) {
-            result++;
+    for (int i = 0; i < count; i++) {
+        if (i == largest) { continue; }
+        uint64_t set = make_set(u);
+        if (set == NO_SET) { break; }
+        for (int w = 0; w < BITBOARD_WORDS; w++) {
+            for (uint64_t bits = parts[i].words[w]; bits != 0;
+                 bits &= bits - 1) {
+                set_node(u, w * 64 + __builtin_ctzll(bits), set);
+            }
         }
     }
-    return result;
+    return count;
 }
 
-bool are_connected(uint32_t **board, uint32_t start_x, uint32_t start_y, uint32_t dest_x,
-                   uint32_t dest_y, uint32_t width, uint32_t height) {
-    if (start_x >= height || start_y >= width ||
-        dest_x >= height || dest_y >= width) {
-        return false;
+Board new_bare_Board(uint32_t width, uint32_t height, uint32_t players,
+                     bool tiled, const Allocator *allocator) {
+    Board b;
+    b.width = width;
+    b.height = height;
+    b.tiled = false;
+    b.stride = (uint64_t) width + 2;
+    b.row_step = b.stride;
+    b.row_mask = 0;
+    b.row_jump = 0;
+    b.column_mask = 0;
+    b.column_jump = 0;
+    if (tiled && !paging(board_size(&b))) {
+        /* Wiersz kafelków obejmuje całą szerokość planszy z ramką,
+         * a kafelek zajmuje 2^(2 * TILE_BITS) kolejnych elementów.
+         */
+        uint64_t side = 1 << TILE_BITS;
+        b.tiled = true;
+        b.stride = (b.stride + side - 1) / side * side * side;
+        b.row_step = side;
+        b.row_mask = (side - 1) * side;
+        b.row_jump = b.stride - side * side;
+        b.column_mask = side - 1;
+        b.column_jump = (side - 1) * side;
     }
-    Stack stack = new_Stack();
-    bool **visited = NULL;
-    visited = safe_malloc(visited, height * sizeof(bool *));
-    for (uint32_t i = 0; i < height; i++) {
-        visited[i] = safe_malloc(visited[i], width * sizeof(bool));
+    b.fields = NULL;
+    b.cells = empty_Pages(sizeof(uint32_t), allocator);
+    b.mark_pages = b.cells;
+    // Ramka musi mieć wartość większą od numeru każdego gracza.
+    if (paging(board_size(&b))) { b.cell_size = sizeof(uint32_t); }
+    else if (players < UINT8_MAX) { b.cell_size = sizeof(uint8_t); }
+    else if (players < UINT16_MAX) { b.cell_size = sizeof(uint16_t); }
+    else { b.cell_size = sizeof(uint32_t); }
+    b.marks = NULL;
+    b.owned = NULL;
+    b.mark = 0;
+    b.failed = false;
+    b.allocator = allocator;
+    for (int i = 0; i < 4; i++) {
+        b.stacks[i] = new_Stack(allocator);
     }
-    push(stack, make_Pair(start_x, start_y));
-    uint32_t p = board[start_x][start_y];
-    for (uint32_t i = 0; i < height; i++) {
-        for (uint32_t j = 0; j < width; j++) {
-            visited[i][j] = false;
-        }
+    if (paging(board_size(&b))) {
+        b.cells = new_Pages(board_size(&b), b.cell_size, allocator);
+        b.failed = b.cells.directory == NULL;
     }
-    visited[start_x][start_y] = true;
-    bool found = false;
-    while (!empty(stack) && !found) {
-        Pair tp = top(stack);
-        pop(stack);
-        uint32_t x = tp.x;
-        uint32_t y = tp.y;
-        if (x == dest_x && y == dest_y) { found = true; }
-        else {
-            if (x > 0 && board[x - 1][y] == p && !visited[x - 1][y]) {
-                push(stack, make_Pair(x - 1, y));
-                visited[x - 1][y] = true;
-            }
-            if (x < height - 1 && board[x + 1][y] == p && !visited[x + 1][y]) {
-                push(stack, make_Pair(x + 1, y));
-                visited[x + 1][y] = true;
-            }
-            if (y > 0 && board[x][y - 1] == p && !visited[x][y - 1]) {
-                push(stack, make_Pair(x, y - 1));
-                visited[x][y - 1] = true;
-            }
-            if (y < width - 1 && board[x][y + 1] == p && !visited[x][y + 1]) {
-                push(stack, make_Pair(x, y + 1));
-                visited[x][y + 1] = true;
-            }
-        }
+    return b;
+}
+
+Board new_Board(uint32_t width, uint32_t height, uint32_t players,
+                bool tiled, const Allocator *allocator) {
+    Board b = new_bare_Board(width, height, players, tiled, allocator);
+    if (b.failed || is_paged(&b)) { return b; }
+    b.fields = safe_malloc(allocator, board_size(&b), b.cell_size);
+    if (b.fields == NULL) {
+        b.failed = true;
+        return b;
     }
-    del(stack);
-    for (uint32_t i = 0; i < height; i++) { free(visited[i]); }
-    free(visited);
-    return found;
-}
-
-uint64_t count_areas(uint32_t **board, Pair fields[4], bool active[4],
-                     uint32_t width, uint32_t height) {
-    int how_many = 0;
-    int representants[4];
-    int first_active = 0;
-    while (first_active < 4 && !active[first_active]) {
-        first_active++;
-    }
-    if (first_active < 4) {
-        how_many = 1;
-        representants[0] = first_active;
-    } else {
-        return 0;
-    }
-    for (int i = first_active + 1; i < 4; i++) {
-        if (active[i]) {
-            bool connected = false;
-            for (int j = 0; j < how_many && !connected; j++) {
-                uint32_t or_x = fields[i].x;
-                uint32_t or_y = fields[i].y;
-                uint32_t dest_x = fields[representants[j]].x;
-                uint32_t dest_y = fields[representants[j]].y;
-                if (are_connected(board, or_x, or_y,
-                                  dest_x, dest_y, width, height)) {
-                    connected = true;
-                }
-            }
-            if (!connected) {
-                representants[how_many] = i;
-                how_many++;
-            }
+    memset(b.fields, 0, board_size(&b) * b.cell_size);
+    BY_CELL_SIZE(&b, fill_border, &b);
+    if (fits_bitboards(&b)) {
+        b.owned = safe_malloc(allocator, (uint64_t) players + 1,
+                              sizeof(Bitboard));
+        if (b.owned == NULL) {
+            b.failed = true;
+            return b;
+        }
+        for (uint32_t p = 0; p <= players; p++) {
+            b.owned[p] = empty_bitboard();
+        }
+        for (uint64_t f = 0; f < board_size(&b); f++) {
+            if (!on_border(&b, f)) { bitboard_add(&b.owned[0], f); }
         }
     }
-    return how_many;
+    return b;
 }
 
-uint64_t count_adjacent_areas(uint32_t **board, uint32_t x, uint32_t y,
-                              uint32_t p, uint32_t width, uint32_t height) {
-    if (x >= height || y >= width) { return 0; }
-    /* Przekazujemy funkcji count_areas (w sposób opisany w board.h)
-     * tylko pola sąsiednie należące da danego gracza.
-     */
-    Pair fields[4];
-    bool active[4] = {false, false, false, false};
-    if (x > 0 && board[x - 1][y] == p) {
-        fields[0] = make_Pair(x - 1, y);
-        active[0] = true;
+Board clone_Board(const Board *b, uint32_t players,
+                  const Allocator *allocator,
+                  const Allocator *page_allocator) {
+    Board c = *b;
+    c.fields = NULL;
+    c.cells = empty_Pages(sizeof(uint32_t), allocator);
+    c.mark_pages = c.cells;
+    c.marks = NULL;
+    c.owned = NULL;
+    c.mark = 0;
+    c.failed = false;
+    c.allocator = allocator;
+    for (int i = 0; i < 4; i++) {
+        c.stacks[i] = new_Stack(allocator);
     }
-    if (x < height - 1 && board[x + 1][y] == p) {
-        fields[1] = make_Pair(x + 1, y);
-        active[1] = true;
+    if (is_paged(b)) {
+        c.cells = clone_Pages(&b->cells, allocator, page_allocator);
+        c.failed = c.cells.directory == NULL;
+        return c;
     }
-    if (y > 0 && board[x][y - 1] == p) {
-        fields[2] = make_Pair(x, y - 1);
-        active[2] = true;
+    c.fields = safe_malloc(allocator, board_size(b), b->cell_size);
+    if (c.fields == NULL) {
+        c.failed = true;
+        return c;
     }
-    if (y < width - 1 && board[x][y + 1] == p) {
-        fields[3] = make_Pair(x, y + 1);
-        active[3] = true;
+    memcpy(c.fields, b->fields, board_size(b) * b->cell_size);
+    if (b->owned != NULL) {
+        c.owned = safe_malloc(allocator, (uint64_t) players + 1,
+                              sizeof(Bitboard));
+        if (c.owned == NULL) {
+            c.failed = true;
+            return c;
+        }
+        memcpy(c.owned, b->owned, ((size_t) players + 1) * sizeof(Bitboard));
     }
-    return count_areas(board, fields, active, width, height);
-}
\ No newline at end of file
+    return c;
+}
+
+void del_Board(Board *b) {
+    safe_free(b->allocator, b->fields);
+    safe_free(b->allocator, b->marks);
+    safe_free(b->allocator, b->owned);
+    del_Pages(&b->cells);
+    del_Pages(&b->mark_pages);
+    for (int i = 0; i < 4; i++) {
+        del(&b->stacks[i]);
+    }
+    b->fields = NULL;
+    b->marks = NULL;
+    b->owned = NULL;
+}
+
+bool has_adjacent(const Board *b, uint64_t f, uint32_t p) {
+    return BY_CELL_SIZE(b, has_adjacent, b, f, p);
+}
+
+uint64_t count_adjacent_free(const Board *b, uint64_t f, uint32_t p) {
+    return BY_CELL_SIZE(b, count_adjacent_free, b, f, p);
+}
+
+int adjacent_owners(const Board *b, uint64_t f, uint32_t p,
+                    uint32_t owners[4]) {
+    return BY_CELL_SIZE(b, adjacent_owners, b, f, p, owners);
+}
+
+uint64_t count_adjacent_sets(const Board *b, UnionFind *u, uint64_t f,
+                             uint32_t p) {
+    return BY_CELL_SIZE(b, count_adjacent_sets, b, u, f, p);
+}
+
+void join_adjacent(const Board *b, UnionFind *u, uint64_t f, uint32_t p) {
+    BY_CELL_SIZE(b, join_adjacent, b, u, f, p);
+}
+
+uint64_t split_area(Board *b, UnionFind *u, uint64_t f, uint32_t p,
+                    uint64_t max_parts) {
+    if (has_bitboards(b)) { return bitboard_split(b, u, f, p, max_parts); }
+    return BY_CELL_SIZE(b, split_area, b, u, f, p, max_parts);
+}
+
+uint64_t bitboard_split_parts(const Board *b, uint64_t f) {
+    uint32_t p = get_field(b, f);
+    uint64_t sources[4];
+    int n = local_groups_8(b, f, p, sources);
+    if (n <= 1) { return n; }
+    Bitboard mask = b->owned[p];
+    bitboard_remove(&mask, f);
+    Bitboard parts[4];
+    return bitboard_parts(b, &mask, sources, n, parts);
+}
+
+char *write_fields(const Board *b, uint64_t f, uint32_t count, char *out) {
+    return BY_CELL_SIZE(b, write_fields, b, f, count, out);
+}
+
+uint64_t fields_width(const Board *b, uint64_t f, uint32_t count) {
+    return BY_CELL_SIZE(b, fields_width, b, f, count);
+}
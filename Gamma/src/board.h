@@ -1,34 +1,425 @@
 /** @file
- * Interfejs funkcji odczytujących odpowiednie dane z planszy gry
- * za pomocą operacji na tablicy dwuwymiarowej o danych rozmiarach.
- * Przyjmuję definicje pol sąsiednich i obszarów z treści zadania.
- * Uwaga! W poniższych funkcjach argument x opisuje nr wiersza, a y
- * nr kolumny danego pola. Ponieważ funkcje z @ref gamma.h przyjmują
- * odwrotnie, będą one wywoływać poniższe z odwróconą kolejnością
- * tych parametrów. Przykład: wywołanie funkcji @ref has_adjacent
- * dla dla gry g, pola o współrzędnych (3,8) w tej grze i gracza nr 1
- * będzie wyglądało tak: has_adjacent(g->board, 8, 3, 1, g->width, g->height)
+ * Interfejs planszy gry oraz funkcji odczytujących z niej
+ * odpowiednie dane. Przyjmuję definicje pol sąsiednich i obszarów
+ * z treści zadania.
+ * Plansza przechowywana jest w jednej tablicy i otoczona ramką z pól
+ * o wartości @ref BORDER. Dzięki ramce każde pole planszy ma czterech
+ * sąsiadów w tablicy, a sąsiada wyznaczają funkcje @ref field_up,
+ * @ref field_down, @ref field_left i @ref field_right, bez sprawdzania,
+ * czy nie wychodzimy poza planszę.
+ * Pola leżą w tablicy wiersz po wierszu albo, w układzie kafelkowym,
+ * w kwadratowych kafelkach o boku 2^@ref TILE_BITS pól, ułożonych wiersz
+ * po wierszu. W układzie wierszowym sąsiad w wierszu powyżej lub poniżej
+ * leży o cały wiersz dalej w pamięci, a w kafelkowym zwykle w tym samym
+ * kafelku, co przyspiesza przeszukiwania dużych obszarów na szerokich
+ * planszach. Poza funkcjami z tego pliku od układu zależy tylko kolejność
+ * pól w zbiorach pól indeksowanych ich numerami (patrz @ref frontier.h).
+ * Uwaga! Poniżej x opisuje nr wiersza, a y nr kolumny danego pola.
+ * Ponieważ funkcje z @ref gamma.h przyjmują odwrotnie, wyznaczają one
+ * numer pola z odwróconą kolejnością tych parametrów. Przykład: wywołanie
+ * funkcji @ref has_adjacent dla gry g, pola o współrzędnych (3,8) w tej
+ * grze i gracza nr 1 będzie wyglądało tak:
+ * has_adjacent(&g->board, field_index(&g->board, 8, 3), 1)
+ * Przeszukiwania planszy oznaczają odwiedzone pola w tablicy znaczników
+ * należącej do planszy. Każde przeszukiwanie używa nowej wartości
+ * znacznika, więc tablicy nie trzeba czyścić, a koszt przeszukiwania
+ * zależy tylko od liczby odwiedzonych pól, a nie od rozmiaru planszy.
+ * Stosy przeszukiwań również należą do planszy i nie są zwalniane
+ * między przeszukiwaniami, więc przeszukiwania nie alokują pamięci,
+ * o ile nie odwiedzą więcej pól niż dotychczasowe.
  */
 
 #ifndef BOARD_H
 #define BOARD_H
 
+#include "bitboard.h"
+#include "pages.h"
 #include "stack.h"
+#include "unionFind.h"
 #include <stdbool.h>
 #include <stdint.h>
 
+/**
+ * Wartość pól ramki otaczającej planszę o polach 4-bajtowych. W planszach
+ * o węższych polach ramkę oznacza największa wartość typu pola.
+ * Nie może być numerem gracza.
+ */
+#define BORDER UINT32_MAX
+
+/**
+ * Logarytm boku kafelka w układzie kafelkowym. Kafelek 8x8 pól
+ * jednobajtowych zajmuje jedną linię pamięci podręcznej.
+ */
+#define TILE_BITS 3
+
+/**
+ * Struktura przechowująca planszę gry.
+ * Pola planszy zajmują 1, 2 lub 4 bajty, zależnie od liczby graczy - im
+ * węższe pola, tym więcej ich mieści się w pamięci podręcznej procesora.
+ * Funkcje przeglądające planszę mają osobne wersje dla każdej szerokości
+ * pola (patrz @ref boardTemplate.h), a funkcje z tego pliku wybierają
+ * odpowiednią z nich.
+ * Plansza większa niż @ref PAGING_THRESHOLD pól (wraz z ramką) ma pola
+ * 4-bajtowe, podzielone na strony (patrz @ref pages.h) - strona powstaje
+ * przy pierwszym zajęciu jej pola, a pola niezaalokowanych stron są wolne
+ * lub należą do ramki. Znaczniki odwiedzin takiej planszy też są
+ * podzielone na strony, więc pamięć zależy tylko od zajętej części planszy.
+ * Mała plansza (co najwyżej @ref BITBOARD_FIELDS pól wraz z ramką)
+ * o polach 1-bajtowych i układzie wierszowym przechowuje dodatkowo zbiory
+ * pól każdego gracza i pól wolnych (patrz @ref bitboard.h). Podziały
+ * obszarów i zbiory pól dostępnych dla graczy wyznaczane są wtedy
+ * operacjami na całych słowach zamiast przeszukiwania planszy.
+ */
+struct board {
+    /*@{*/
+    void *fields; /**< pola planszy wraz z ramką lub NULL dla planszy
+                   * podzielonej na strony */
+    Pages cells; /**< pola planszy podzielonej na strony (katalog stron
+                  * jest NULL-em dla zwykłej planszy) */
+    uint32_t *marks; /**< znaczniki odwiedzin pól, alokowane przy
+                      * pierwszym przeszukiwaniu planszy */
+    Pages mark_pages; /**< znaczniki odwiedzin pól planszy podzielonej
+                       * na strony */
+    uint32_t mark; /**< ostatnia użyta wartość znacznika */
+    bool failed; /**< czy nie udało się zaalokować pól, stron pól
+                  * lub znaczników */
+    const Allocator *allocator; /**< alokator pamięci lub NULL */
+    Stack stacks[4]; /**< stosy przeszukiwań planszy */
+    Bitboard *owned; /**< zbiory pól kolejnych graczy (pod indeksem 0 -
+                      * pól wolnych) małej planszy lub NULL */
+    uint32_t width; /**< szerokość planszy (bez ramki) */
+    uint32_t height; /**< wysokość planszy (bez ramki) */
+    bool tiled; /**< czy pola leżą w układzie kafelkowym */
+    uint64_t stride; /**< odległość w tablicy między sąsiednimi wierszami
+                      * (w układzie kafelkowym - wierszami kafelków) */
+    uint64_t row_step; /**< odległość w tablicy między polami sąsiednich
+                        * wierszy w jednym kafelku (lub w całej planszy) */
+    uint64_t row_mask; /**< bity numeru pola z numerem wiersza
+                        * w kafelku (w układzie kafelkowym) */
+    uint64_t row_jump; /**< dodatkowe przesunięcie przy przejściu
+                        * do kafelka powyżej lub poniżej */
+    uint64_t column_mask; /**< bity numeru pola z numerem kolumny
+                           * w kafelku (w układzie kafelkowym) */
+    uint64_t column_jump; /**< dodatkowe przesunięcie przy przejściu
+                           * do kafelka po lewej lub po prawej */
+    uint8_t cell_size; /**< liczba bajtów zajmowanych przez jedno pole */
+    /*@{*/
+};
+/**
+ * Typ Board - alias na struct board.
+ */
+typedef struct board Board;
+
+/** @brief Tworzy pustą planszę o danych wymiarach, otoczoną ramką.
+ * Dobiera najwęższy typ pola, w którym mieszczą się numery wszystkich
+ * graczy i wartość ramki. Plansza podzielona na strony ma zawsze układ
+ * wierszowy. Mała plansza dostaje zbiory pól graczy.
+ * @param[in] width - szerokość planszy
+ * @param[in] height - wysokość planszy
+ * @param[in] players - liczba graczy, mniejsza od @ref BORDER
+ * @param[in] tiled - czy pola mają leżeć w układzie kafelkowym
+ * @param[in] allocator - alokator pamięci lub NULL (funkcje biblioteki
+ * standardowej), musi istnieć tak długo jak struktura
+ * @return Nowa plansza. Jeśli nie udało się zaalokować pamięci, jej pole
+ * @p failed ma wartość @p true.
+ */
+Board new_Board(uint32_t width, uint32_t height, uint32_t players,
+                bool tiled, const Allocator *allocator);
+
+/** @brief Tworzy planszę o danych wymiarach bez pól.
+ * Dobiera typ pola i układ planszy jak @ref new_Board, ale nie alokuje
+ * pól ani zbiorów pól graczy - wywołujący podłącza je sam (np. z obrazu
+ * gry odwzorowanego w pamięci, patrz @ref snapshot.h). Plansza podzielona
+ * na strony dostaje katalog bez żadnej strony.
+ * @param[in] width - szerokość planszy
+ * @param[in] height - wysokość planszy
+ * @param[in] players - liczba graczy, mniejsza od @ref BORDER
+ * @param[in] tiled - czy pola mają leżeć w układzie kafelkowym
+ * @param[in] allocator - alokator pamięci lub NULL (funkcje biblioteki
+ * standardowej), musi istnieć tak długo jak struktura
+ * @return Nowa plansza. Jeśli nie udało się zaalokować katalogu stron,
+ * jej pole @p failed ma wartość @p true.
+ */
+Board new_bare_Board(uint32_t width, uint32_t height, uint32_t players,
+                     bool tiled, const Allocator *allocator);
+
+/** @brief Tworzy kopię planszy.
+ * Kopia ma własne znaczniki i stosy. Plansza podzielona na strony
+ * współdzieli z kopią strony pól (patrz @ref clone_Pages), mniejsza
+ * plansza jest kopiowana w całości.
+ * @param[in] b - plansza
+ * @param[in] players - liczba graczy
+ * @param[in] allocator - alokator pamięci kopii lub NULL (funkcje biblioteki
+ * standardowej), musi istnieć tak długo jak kopia
+ * @param[in] page_allocator - alokator stron pól kopii, ten sam co planszy
+ * @p b
+ * @return Kopia planszy. Jeśli nie udało się zaalokować pamięci, jej pole
+ * @p failed ma wartość @p true.
+ */
+Board clone_Board(const Board *b, uint32_t players,
+                  const Allocator *allocator,
+                  const Allocator *page_allocator);
+
+/** @brief Usuwa planszę.
+ * Zwalnia pamięć zaalokowaną na pola planszy, znaczniki i stosy.
+ * @param[in, out] b - plansza
+ */
+void del_Board(Board *b);
+
+/** @brief Liczba elementów tablicy pól planszy (wraz z ramką).
+ * W układzie kafelkowym obejmuje też pola kafelków wystające poza ramkę,
+ * które mają wartość ramki.
+ * @param[in] b - plansza
+ * @return liczba elementów tablicy @p b->fields
+ */
+static inline uint64_t board_size(const Board *b) {
+    uint64_t rows = (uint64_t) b->height + 2;
+    if (b->tiled) { rows = (rows + (1 << TILE_BITS) - 1) >> TILE_BITS; }
+    return rows * b->stride;
+}
+
+/** @brief Wyznacza numer pola o danych współrzędnych w planszy z ramką
+ * (pierwszy wiersz i pierwsza kolumna ramki mają numer 0).
+ * @param[in] b - plansza
+ * @param[in] row - nr wiersza
+ * @param[in] column - nr kolumny
+ * @return numer pola w tablicy @p b->fields
+ */
+static inline uint64_t frame_index(const Board *b, uint64_t row,
+                                   uint64_t column) {
+    if (!b->tiled) { return row * b->stride + column; }
+    uint64_t inside = (1 << TILE_BITS) - 1;
+    return (row >> TILE_BITS) * b->stride +
+           ((column >> TILE_BITS) << (2 * TILE_BITS)) +
+           ((row & inside) << TILE_BITS) + (column & inside);
+}
+
+/** @brief Wyznacza współrzędne pola w planszy z ramką
+ * (odwrotność @ref frame_index).
+ * @param[in] b - plansza
+ * @param[in] f - numer pola
+ * @param[out] row - nr wiersza
+ * @param[out] column - nr kolumny
+ */
+static inline void frame_position(const Board *b, uint64_t f,
+                                  uint64_t *row, uint64_t *column) {
+    if (!b->tiled) {
+        *row = f / b->stride;
+        *column = f % b->stride;
+        return;
+    }
+    uint64_t inside = (1 << TILE_BITS) - 1;
+    uint64_t tile = f % b->stride;
+    *row = (f / b->stride << TILE_BITS) +
+           ((tile >> TILE_BITS) & inside);
+    *column = (tile >> (2 * TILE_BITS) << TILE_BITS) + (tile & inside);
+}
+
+/** @brief Wyznacza numer pola w tablicy pól planszy.
+ * @param[in] b - plansza
+ * @param[in] x - nr wiersza pola
+ * @param[in] y - nr kolumny pola
+ * @return numer pola (x, y) w tablicy @p b->fields
+ */
+static inline uint64_t field_index(const Board *b, uint32_t x, uint32_t y) {
+    return frame_index(b, (uint64_t) x + 1, (uint64_t) y + 1);
+}
+
+/** @brief Wyznacza współrzędne pola o danym numerze
+ * (odwrotność @ref field_index).
+ * @param[in] b - plansza
+ * @param[in] f - numer pola leżącego na planszy (nie w ramce)
+ * @param[out] x - nr wiersza pola
+ * @param[out] y - nr kolumny pola
+ */
+static inline void field_position(const Board *b, uint64_t f,
+                                  uint32_t *x, uint32_t *y) {
+    uint64_t row, column;
+    frame_position(b, f, &row, &column);
+    *x = row - 1;
+    *y = column - 1;
+}
+
+/* Sąsiedzi pola. W układzie wierszowym wystarczy dodać przesunięcie,
+ * a w kafelkowym przy brzegu kafelka trzeba przeskoczyć do kafelka obok.
+ * Rozgałęzienie zależy tylko od planszy, więc procesor je przewiduje,
+ * a układ wierszowy nie płaci za obliczenia na maskach.
+ */
+
+/** @brief Wyznacza sąsiada pola w wierszu powyżej.
+ * @param[in] b - plansza
+ * @param[in] f - numer pola leżącego na planszy (nie w ramce)
+ * @return numer sąsiada
+ */
+static inline uint64_t field_up(const Board *b, uint64_t f) {
+    if (!b->tiled) { return f - b->stride; }
+    return f - b->row_step - ((f & b->row_mask) == 0 ? b->row_jump : 0);
+}
+
+/** @brief Wyznacza sąsiada pola w wierszu poniżej.
+ * @param[in] b - plansza
+ * @param[in] f - numer pola leżącego na planszy (nie w ramce)
+ * @return numer sąsiada
+ */
+static inline uint64_t field_down(const Board *b, uint64_t f) {
+    if (!b->tiled) { return f + b->stride; }
+    return f + b->row_step +
+           ((f & b->row_mask) == b->row_mask ? b->row_jump : 0);
+}
+
+/** @brief Wyznacza sąsiada pola w kolumnie po lewej.
+ * @param[in] b - plansza
+ * @param[in] f - numer pola leżącego na planszy (nie w ramce)
+ * @return numer sąsiada
+ */
+static inline uint64_t field_left(const Board *b, uint64_t f) {
+    if (!b->tiled) { return f - 1; }
+    return f - 1 - ((f & b->column_mask) == 0 ? b->column_jump : 0);
+}
+
+/** @brief Wyznacza sąsiada pola w kolumnie po prawej.
+ * @param[in] b - plansza
+ * @param[in] f - numer pola leżącego na planszy (nie w ramce)
+ * @return numer sąsiada
+ */
+static inline uint64_t field_right(const Board *b, uint64_t f) {
+    if (!b->tiled) { return f + 1; }
+    return f + 1 +
+           ((f & b->column_mask) == b->column_mask ? b->column_jump : 0);
+}
+
+/** @brief Zapisuje sąsiadów pola: górnego, dolnego, lewego i prawego.
+ * @param[in] b - plansza
+ * @param[in] f - numer pola leżącego na planszy (nie w ramce)
+ * @param[out] neighbours - numery sąsiadów
+ */
+static inline void adjacent_fields(const Board *b, uint64_t f,
+                                   uint64_t neighbours[4]) {
+    neighbours[0] = field_up(b, f);
+    neighbours[1] = field_down(b, f);
+    neighbours[2] = field_left(b, f);
+    neighbours[3] = field_right(b, f);
+}
+
+/** @brief Podaje wartość pól ramki planszy.
+ * @param[in] b - plansza
+ * @return największa wartość typu pola planszy
+ */
+static inline uint32_t border_value(const Board *b) {
+    switch (b->cell_size) {
+        case 1: return UINT8_MAX;
+        case 2: return UINT16_MAX;
+        default: return BORDER;
+    }
+}
+
+/** @brief Sprawdza, czy plansza jest podzielona na strony.
+ * @param[in] b - plansza
+ * @return wartość @p true, jeśli pola planszy są podzielone na strony,
+ * @p false w przeciwnym wypadku
+ */
+static inline bool is_paged(const Board *b) {
+    return b->cells.directory != NULL;
+}
+
+/** @brief Sprawdza, czy pole należy do ramki planszy.
+ * @param[in] b - plansza
+ * @param[in] f - numer pola
+ * @return wartość @p true, jeśli pole leży w ramce, @p false w przeciwnym
+ * wypadku
+ */
+static inline bool on_border(const Board *b, uint64_t f) {
+    uint64_t row, column;
+    frame_position(b, f, &row, &column);
+    return row == 0 || row > b->height || column == 0 || column > b->width;
+}
+
+/** @brief Odczytuje wartość pola planszy podzielonej na strony.
+ * @param[in] b - plansza podzielona na strony
+ * @param[in] f - numer pola
+ * @return wartość pola
+ */
+static inline uint32_t paged_field(const Board *b, uint64_t f) {
+    const uint32_t *page = find_page(&b->cells, f);
+    if (page == NULL) { return on_border(b, f) ? BORDER : 0; }
+    return page[page_offset(f)];
+}
+
+/** @brief Zapisuje wartość pola planszy podzielonej na strony.
+ * Alokuje stronę pola, jeśli jej jeszcze nie ma. Jeśli się to nie uda,
+ * zapamiętuje błąd w polu @p failed planszy i nic nie zapisuje.
+ * @param[in, out] b - plansza podzielona na strony
+ * @param[in] f - numer pola leżącego na planszy (nie w ramce)
+ * @param[in] p - nowa wartość pola
+ */
+void set_paged_field(Board *b, uint64_t f, uint32_t p);
+
+/** @brief Sprawdza, czy plansza jest na tyle mała, by przechowywać zbiory
+ * pól graczy.
+ * @param[in] b - plansza
+ * @return wartość @p true, jeśli plansza ma układ wierszowy, pola
+ * 1-bajtowe i co najwyżej @ref BITBOARD_FIELDS pól wraz z ramką,
+ * @p false w przeciwnym wypadku
+ */
+static inline bool fits_bitboards(const Board *b) {
+    return !b->tiled && b->cell_size == sizeof(uint8_t) &&
+           board_size(b) <= BITBOARD_FIELDS;
+}
+
+/** @brief Sprawdza, czy plansza przechowuje zbiory pól graczy.
+ * @param[in] b - plansza
+ * @return wartość @p true, jeśli plansza jest mała i ma zbiory pól graczy,
+ * @p false w przeciwnym wypadku
+ */
+static inline bool has_bitboards(const Board *b) {
+    return b->owned != NULL;
+}
+
+/** @brief Odczytuje wartość pola planszy.
+ * @param[in] b - plansza
+ * @param[in] f - numer pola leżącego na planszy (nie w ramce)
+ * @return nr gracza zajmującego pole lub 0, jeśli pole jest wolne
+ */
+static inline uint32_t get_field(const Board *b, uint64_t f) {
+    if (is_paged(b)) { return paged_field(b, f); }
+    switch (b->cell_size) {
+        case 1: return ((const uint8_t *) b->fields)[f];
+        case 2: return ((const uint16_t *) b->fields)[f];
+        default: return ((const uint32_t *) b->fields)[f];
+    }
+}
+
+/** @brief Zapisuje wartość pola planszy.
+ * @param[in, out] b - plansza
+ * @param[in] f - numer pola leżącego na planszy (nie w ramce)
+ * @param[in] p - nr gracza zajmującego pole lub 0 dla pola wolnego
+ */
+static inline void set_field(Board *b, uint64_t f, uint32_t p) {
+    if (is_paged(b)) {
+        set_paged_field(b, f, p);
+        return;
+    }
+    switch (b->cell_size) {
+        case 1:
+            if (b->owned != NULL) {
+                bitboard_remove(&b->owned[((uint8_t *) b->fields)[f]], f);
+                bitboard_add(&b->owned[p], f);
+            }
+            ((uint8_t *) b->fields)[f] = p;
+            break;
+        case 2: ((uint16_t *) b->fields)[f] = p; break;
+        default: ((uint32_t *) b->fields)[f] = p; break;
+    }
+}
+
 /** @brief Sprawdza, czy dane pole graniczy z polem należącym do danego gracza.
- * @param[in] board – plansza gry
- * @param[in] x - nr wiersza danego pola
- * @param[in] y - nr kolumny danego pola
+ * @param[in] b – plansza gry
+ * @param[in] f - numer danego pola
  * @param[in] p - nr danego gracza
- * @param[in] width - wysokość planszy
- * @param[in] height - szerokość planszy
  * @return wartość @p true, jesli dane pole graniczy z co najmniej jednym
  * polem należącym do danego gracza, @p false w przeciwnym wypadku.
  */
-bool has_adjacent(uint32_t **board, uint32_t x, uint32_t y, uint32_t p,
-                  uint32_t width, uint32_t height);
+bool has_adjacent(const Board *b, uint64_t f, uint32_t p);
 
 /** @brief Liczy nowe puste pola przyległe do danego.
  * Ponieważ celem funkcji jest informowanie, ile nowych wolnych
@@ -39,76 +430,107 @@ bool has_adjacent(uint32_t **board, uint32_t x, uint32_t y, uint32_t p,
  * Kiedy ten gracz zechce zająć pole (1,1) zyska 2 nowe pola przyległe:
  * (1,2) i (2,1), nie liczymy już pól (0,1) i (1,0), one zostały dodane przy
  * zajmowaniu pola (0,0).
- * @param[in] board – plansza gry
- * @param[in] x - nr wiersza danego pola
- * @param[in] y - nr kolumny danego pola
+ * @param[in] b – plansza gry
+ * @param[in] f - numer danego pola
  * @param[in] p - nr danego gracza
- * @param[in] width - wysokość planszy
- * @param[in] height - szerokość planszy
  * @return liczba nowych (wg def. powyżej) pustych pól przyległych do danego.
  */
-uint64_t count_adjacent_free(uint32_t **board, uint32_t x, uint32_t y,
-                             uint32_t p, uint32_t width, uint32_t height);
-
-
-/** @brief Sprawdza, czy dane 2 pola należą do jednego obszaru,
- * z wykorzystaniem algorytmu DFS.
- * @param[in] board   – plansza gry,
- * @param[in] start_x - nr wiersza pola 1 (startowego)
- * @param[in] start_y - nr kolumny pola 1 (startowego)
- * @param[in] dest_x - nr wiersza pola 2 (docelowego)
- * @param[in] dest_y - nr kolumny pola 2 (docelowego)
- * @param[in] width - wysokość planszy
- * @param[in] height - szerokość planszy
- * @return wartość @p true, jesli pola należą do jednego obszaru,
- * @p false w przeciwnym wypadku.
- */
-bool are_connected(uint32_t **board, uint32_t start_x, uint32_t start_y,
-         uint32_t dest_x, uint32_t dest_y, uint32_t width, uint32_t height);
-
-/** @brief Sprawdza, do ilu obszarów należą dane pola (max 4)
- * Nietypowa postać przyjmowanych argumentów spowodowana jest tym, że
- * funkcję tą wykorzystuje @ref count_adjacent_areas. Przekazuje ona
- * tej funkcji pola sąsiadujące z danym i należące do danego gracza.
- * Takich pól może być od 0 do 4, a taki format pozwala na ich
- * przekazywanie w jednolity sposób, bez alokacji dodatkowej pamięci,
- * niezależnie od ich ilości.
- * @param[in] board – plansza gry
- * @param[in] active - informuje o tym, które elementy z tablicy
- * fields brać pod uwagę. (zakłada, że jesli active[i] == false, to wartość
- * pod fields[i] jest niezainicjalizowana i nie bierze jej pod uwagę)
- * @param[in] fields - tablica pól do sprawdzenia
- * @param[in] board   – plansza reprezentująca stan gry,
- * @param[in] width - wysokość planszy
- * @param[in] height - szerokość planszy
- * @return liczba obszarów, do których należą dane pola.
- */
-uint64_t count_areas(uint32_t **board, Pair fields[4], bool active[4],
-                     uint32_t width, uint32_t height);
+uint64_t count_adjacent_free(const Board *b, uint64_t f, uint32_t p);
+
+/** @brief Zapisuje właścicieli pól sąsiadujących z danym, innych niż
+ * dany gracz. Każdy właściciel zapisywany jest raz, nawet jeśli
+ * posiada kilka pól sąsiednich. Pola wolne i ramka są pomijane.
+ * @param[in] b – plansza gry
+ * @param[in] f - numer danego pola
+ * @param[in] p - nr danego gracza
+ * @param[out] owners - tablica, w której zapisywani są właściciele
+ * @return liczba zapisanych właścicieli (od 0 do 4)
+ */
+int adjacent_owners(const Board *b, uint64_t f, uint32_t p,
+                    uint32_t owners[4]);
 
 /** @brief Liczy, do ilu obszarów danego gracza należą pola
- * sąsiadujące z danym, z wykorzystaniem @ref count_areas.
- * Wykorzystywana w celu określenia zmiany liczby obszarów
- * danego gracza po zajęciu danego pola (na skutek zwykłego lub
- * złotego ruchu) lub utraty danego pola (na skutek złotego ruchu innego
- * gracza). Przykład: gracz 1 zajął 4 pola - (0,0), (0,1), (1,0) i (1,2).
+ * sąsiadujące z danym, korzystając ze struktury zbiorów rozłącznych.
+ * Zamiast przeszukiwać planszę porównuje reprezentantów zbiorów, w których
+ * leżą pola sąsiednie, więc działa w czasie praktycznie stałym.
+ * Przykład: gracz 1 zajął 4 pola - (0,0), (0,1), (1,0) i (1,2).
  * Funkcja wywołana dla gracza 1 i pola (1,1) zwróci 2 (bo gracz posiada 3
  * pola sąsiadujące z (1,1), ale 2 z nich należą do 1 obszaru). Ponieważ
  * wszystkie obszary, do których należą pola sąsiednie złaczą się w 1 po
  * zajęciu przez gracza danego pola, możemy ustalić jak zmieni się liczba
- * obszarów gracza. W przykładzie 2 obszary zredukują sie do 1, zatem liczba
- * obszarów należących do gracza 1 zmniejszy się o 1.
- * @param[in] board - plansza gry
- * @param[in] x - nr wiersza danego pola
- * @param[in] y - nr kolumny danego pola
+ * obszarów gracza.
+ * @param[in] b - plansza gry
+ * @param[in, out] u - obszary graczy
+ * @param[in] f - numer danego pola
  * @param[in] p - nr danego gracza
- * @param[in] width - wysokość planszy
- * @param[in] height - szerokość planszy
  * @return liczba obszarów danego gracza, do których należą
  * pola sąsiadujące z danym
  */
-uint64_t count_adjacent_areas(uint32_t **board, uint32_t x, uint32_t y,
-                              uint32_t p, uint32_t width, uint32_t height);
+uint64_t count_adjacent_sets(const Board *b, UnionFind *u, uint64_t f,
+                             uint32_t p);
 
+/** @brief Dołącza dane pole do obszarów danego gracza.
+ * Tworzy zbiór zawierający dane pole i łączy go ze zbiorami wszystkich
+ * pól sąsiednich należących do danego gracza. Wywoływana po zajęciu
+ * pola przez gracza (zwykłym lub złotym ruchem).
+ * @param[in] b - plansza gry
+ * @param[in, out] u - obszary graczy
+ * @param[in] f - numer danego pola
+ * @param[in] p - nr danego gracza
+ */
+void join_adjacent(const Board *b, UnionFind *u, uint64_t f, uint32_t p);
+
+/** @brief Dzieli obszar gracza, który stracił dane pole.
+ * Utrata pola (na skutek złotego ruchu) może podzielić obszar na kilka
+ * części, czego sama struktura zbiorów rozłącznych nie potrafi wyrazić.
+ * Jeśli pola sąsiednie gracza łączą się wokół danego pola przez pola
+ * narożne, obszar na pewno się nie dzieli. W przeciwnym wypadku funkcja
+ * uruchamia przeszukiwania (DFS) ze wszystkich sąsiadów naraz, wykonując
+ * ich kroki na zmianę, i kończy, gdy co najwyżej jedno z nich wciąż
+ * trwa. Odłączone części przeglądane są więc w czasie proporcjonalnym
+ * do ich rozmiaru, a największa z nich nie musi być przeglądana w całości.
+ * Jeśli części jest nie więcej niż @p max_parts, odłączone części dostają
+ * w strukturze nowe zbiory. W przeciwnym wypadku przeszukiwanie jest
+ * przerywane, a struktura pozostaje bez zmian.
+ * Zakłada, że dane pole jest już puste.
+ * @param[in, out] b - plansza gry
+ * @param[in, out] u - obszary graczy
+ * @param[in] f - numer danego pola
+ * @param[in] p - nr gracza, który stracił pole
+ * @param[in] max_parts - dopuszczalna liczba części
+ * @return liczba części, na które rozpadł się obszar (0, jeśli pole
+ * nie miało sąsiadów danego gracza), lub liczba większa od
+ * @p max_parts, jeśli części jest za dużo albo nie udało się zaalokować
+ * pamięci na znaczniki.
+ */
+uint64_t split_area(Board *b, UnionFind *u, uint64_t f, uint32_t p,
+                    uint64_t max_parts);
+
+/** @brief Liczy, na ile części rozpadnie się obszar pola po jego zabraniu.
+ * Wypełnia obszar z pól sąsiednich operacjami na zbiorach pól, bez
+ * zmiany planszy. Tylko dla planszy ze zbiorami pól graczy.
+ * @param[in] b - plansza gry ze zbiorami pól graczy
+ * @param[in] f - numer zajętego pola
+ * @return liczba części (od 0 do 4)
+ */
+uint64_t bitboard_split_parts(const Board *b, uint64_t f);
+
+/** @brief Zapisuje tekstowy opis kolejnych pól planszy (patrz @ref printer.h).
+ * @param[in] b - plansza gry
+ * @param[in] f - numer pierwszego pola
+ * @param[in] count - liczba pól, leżących w tablicy kolejno po sobie
+ * @param[out] out - bufor, w którym zapisujemy opis, musi pomieścić
+ * sumę @ref number_width wartości opisywanych pól
+ * @return wskaźnik na pierwszy znak za zapisanym opisem
+ */
+char *write_fields(const Board *b, uint64_t f, uint32_t count, char *out);
+
+/** @brief Liczy długość tekstowego opisu kolejnych pól planszy.
+ * @param[in] b - plansza gry
+ * @param[in] f - numer pierwszego pola
+ * @param[in] count - liczba pól, leżących w tablicy kolejno po sobie
+ * @return liczba znaków, które zapisze @ref write_fields dla tych pól
+ */
+uint64_t fields_width(const Board *b, uint64_t f, uint32_t count);
 
 #endif //GAMMA_BOARD_H
@@ -0,0 +1,397 @@
+/** @file
+ * Szablon funkcji przeglądających planszę, dołączany w @ref board.c
+ * osobno dla każdej szerokości pola planszy.
+ * Przed dołączeniem należy zdefiniować makra:
+ * CELL - typ pola planszy (uint8_t, uint16_t lub uint32_t),
+ * SUFFIX(name) - nazwa funkcji z przyrostkiem danej szerokości pola,
+ * PAGED - tylko dla wersji dla planszy podzielonej na strony.
+ * Dzięki temu kompilator generuje dla każdej szerokości kod operujący
+ * bezpośrednio na tablicy pól danego typu, bez rozgałęzień przy każdym
+ * odczycie pola. Opisy funkcji publicznych znajdują się w @ref board.h.
+ * Plik celowo nie ma strażnika dołączania.
+ */
+
+/**
+ * Wartość pól ramki w planszy o polach typu CELL.
+ */
+#define CELL_BORDER ((CELL) BORDER)
+
+#ifdef PAGED
+
+/**
+ * Odczytuje pole planszy.
+ */
+#define CELL_AT(b, f) paged_field(b, f)
+/**
+ * Odczytuje znacznik odwiedzin pola.
+ */
+#define MARK_AT(b, f) paged_mark(b, f)
+/**
+ * Zapisuje znacznik odwiedzin pola.
+ */
+#define SET_MARK(b, f, mark) set_paged_mark(b, f, mark)
+
+/** @brief Wypełnia ramkę planszy.
+ * Ramka planszy podzielonej na strony nie jest zapisywana z góry - nowe
+ * strony dostają ją przy alokacji, a niezaalokowane odczytują ją
+ * ze współrzędnych pola.
+ * @param[in, out] b - plansza gry
+ */
+static void SUFFIX(fill_border)(Board *b) {
+    (void) b;
+}
+
+#else
+
+/**
+ * Odczytuje pole planszy.
+ */
+#define CELL_AT(b, f) (((const CELL *) (b)->fields)[f])
+/**
+ * Odczytuje znacznik odwiedzin pola.
+ */
+#define MARK_AT(b, f) ((b)->marks[f])
+/**
+ * Zapisuje znacznik odwiedzin pola.
+ */
+#define SET_MARK(b, f, mark) ((b)->marks[f] = (mark))
+
+/** @brief Wypełnia ramkę planszy.
+ * @param[in, out] b - plansza gry z wyzerowanymi polami
+ */
+static void SUFFIX(fill_border)(Board *b) {
+    CELL *fields = b->fields;
+    if (b->tiled) {
+        /* Kafelki przy brzegach wystają poza ramkę, więc najprościej
+         * wypełnić ramką całą tablicę i wyczyścić pola planszy.
+         */
+        for (uint64_t i = 0; i < board_size(b); i++) {
+            fields[i] = CELL_BORDER;
+        }
+        for (uint32_t x = 0; x < b->height; x++) {
+            for (uint32_t y = 0; y < b->width; y++) {
+                fields[field_index(b, x, y)] = 0;
+            }
+        }
+        return;
+    }
+    // Ramka: pierwszy i ostatni wiersz oraz pierwsza i ostatnia kolumna.
+    for (uint64_t i = 0; i < b->stride; i++) {
+        fields[i] = CELL_BORDER;
+        fields[board_size(b) - 1 - i] = CELL_BORDER;
+    }
+    for (uint64_t i = 1; i <= b->height; i++) {
+        fields[i * b->stride] = CELL_BORDER;
+        fields[i * b->stride + b->width + 1] = CELL_BORDER;
+    }
+}
+
+#endif
+
+static bool SUFFIX(has_adjacent)(const Board *b, uint64_t f, uint32_t p) {
+    return CELL_AT(b, field_up(b, f)) == p ||
+           CELL_AT(b, field_down(b, f)) == p ||
+           CELL_AT(b, field_left(b, f)) == p ||
+           CELL_AT(b, field_right(b, f)) == p;
+}
+
+static uint64_t SUFFIX(count_adjacent_free)(const Board *b, uint64_t f,
+                                            uint32_t p) {
+    uint64_t result = 0;
+    uint64_t neighbours[4];
+    adjacent_fields(b, f, neighbours);
+    for (int i = 0; i < 4; i++) {
+        if (CELL_AT(b, neighbours[i]) == 0 &&
+            !SUFFIX(has_adjacent)(b, neighbours[i], p)) {
+            result++;
+        }
+    }
+    return result;
+}
+
+static int SUFFIX(adjacent_owners)(const Board *b, uint64_t f, uint32_t p,
+                                   uint32_t owners[4]) {
+    uint64_t neighbours[4];
+    adjacent_fields(b, f, neighbours);
+    int how_many = 0;
+    for (int i = 0; i < 4; i++) {
+        CELL owner = CELL_AT(b, neighbours[i]);
+        if (owner == 0 || owner == p || owner == CELL_BORDER) { continue; }
+        bool seen = false;
+        for (int j = 0; j < how_many && !seen; j++) {
+            if (owners[j] == owner) { seen = true; }
+        }
+        if (!seen) { owners[how_many++] = owner; }
+    }
+    return how_many;
+}
+
+/** @brief Zapisuje pola sąsiadujące z danym i należące do danego gracza.
+ * @param[in] b - plansza gry
+ * @param[in] f - numer danego pola
+ * @param[in] p - nr danego gracza
+ * @param[out] result - tablica, w której zapisywane są znalezione pola
+ * @return liczba znalezionych pól (od 0 do 4)
+ */
+static int SUFFIX(owned_neighbours)(const Board *b, uint64_t f, uint32_t p,
+                                    uint64_t result[4]) {
+    uint64_t neighbours[4];
+    adjacent_fields(b, f, neighbours);
+    int n = 0;
+    for (int i = 0; i < 4; i++) {
+        if (CELL_AT(b, neighbours[i]) == p) { result[n++] = neighbours[i]; }
+    }
+    return n;
+}
+
+static uint64_t SUFFIX(count_adjacent_sets)(const Board *b, UnionFind *u,
+                                            uint64_t f, uint32_t p) {
+    uint64_t fields[4];
+    int n = SUFFIX(owned_neighbours)(b, f, p, fields);
+    uint64_t roots[4];
+    uint64_t how_many = 0;
+    for (int i = 0; i < n; i++) {
+        uint64_t root = find_field(u, fields[i]);
+        bool seen = false;
+        for (uint64_t j = 0; j < how_many && !seen; j++) {
+            if (roots[j] == root) { seen = true; }
+        }
+        if (!seen) { roots[how_many++] = root; }
+    }
+    return how_many;
+}
+
+static void SUFFIX(join_adjacent)(const Board *b, UnionFind *u, uint64_t f,
+                                  uint32_t p) {
+    uint64_t fields[4];
+    int n = SUFFIX(owned_neighbours)(b, f, p, fields);
+    /* Pole bez sąsiadów danego gracza tworzy nowy obszar, w przeciwnym
+     * razie wskazuje na element pierwszego sąsiada, a pozostałe obszary
+     * dołączamy do jego zbioru.
+     */
+    if (n == 0) {
+        uint64_t set = make_set(u);
+        if (set != NO_SET) { set_node(u, f, set); }
+        return;
+    }
+    set_node(u, f, node_of(u, fields[0]));
+    for (int i = 1; i < n; i++) {
+        unite(u, node_of(u, f), node_of(u, fields[i]));
+    }
+}
+
+/** @brief Dzieli pola sąsiednie danego gracza na grupy połączone lokalnie.
+ * Dwa kolejne (w kolejności obrotu wokół pola) pola sąsiednie należą
+ * do jednej grupy, jeśli pole narożne między nimi również należy
+ * do gracza - wtedy na pewno są w jednym obszarze, nawet po utracie
+ * danego pola. Jeśli wszystkie pola sąsiednie tworzą jedną grupę,
+ * utrata pola nie dzieli obszaru i nie trzeba przeszukiwać planszy.
+ * @param[in] b - plansza gry
+ * @param[in] f - numer danego pola
+ * @param[in] p - nr danego gracza
+ * @param[out] sources - po jednym polu z każdej grupy
+ * @return liczba grup (od 0 do 4)
+ */
+static int SUFFIX(local_groups)(const Board *b, uint64_t f, uint32_t p,
+                                uint64_t sources[4]) {
+    /* Pola sąsiednie w kolejności: góra, prawo, dół, lewo, i pola
+     * narożne między kolejnymi z nich.
+     */
+    uint64_t neighbours[4] = {field_up(b, f), field_right(b, f),
+                              field_down(b, f), field_left(b, f)};
+    uint64_t corners[4] = {field_right(b, neighbours[0]),
+                           field_down(b, neighbours[1]),
+                           field_left(b, neighbours[2]),
+                           field_up(b, neighbours[3])};
+    bool owned[4];
+    int group[4];
+    for (int i = 0; i < 4; i++) {
+        owned[i] = CELL_AT(b, neighbours[i]) == p;
+        group[i] = i;
+    }
+    for (int i = 0; i < 4; i++) {
+        int j = (i + 1) % 4;
+        if (owned[i] && owned[j] && CELL_AT(b, corners[i]) == p) {
+            int old = group[j];
+            for (int l = 0; l < 4; l++) {
+                if (group[l] == old) { group[l] = group[i]; }
+            }
+        }
+    }
+    int how_many = 0;
+    for (int i = 0; i < 4; i++) {
+        bool first = owned[i];
+        for (int j = 0; j < i && first; j++) {
+            if (owned[j] && group[j] == group[i]) { first = false; }
+        }
+        if (first) {
+            sources[how_many++] = neighbours[i];
+        }
+    }
+    return how_many;
+}
+
+/** @brief Przepina pola zakończonej części obszaru na nowy element.
+ * Przechodzi (DFS) pola części odwiedzone w bieżącym przeszukiwaniu
+ * i oznacza je znacznikiem @p done.
+ * @param[in, out] b - plansza gry
+ * @param[in, out] u - obszary graczy
+ * @param[in] start - dowolne pole części
+ * @param[in] p - nr danego gracza
+ * @param[in] done - znacznik pól już przepiętych
+ */
+static void SUFFIX(relink_part)(Board *b, UnionFind *u, uint64_t start,
+                                uint32_t p, uint32_t done) {
+    uint64_t set = make_set(u);
+    if (set == NO_SET) { return; }
+    Stack *stack = &b->stacks[0];
+    clear(stack);
+    set_node(u, start, set);
+    SET_MARK(b, start, done);
+    push(stack, start);
+    while (!empty(stack) && !b->failed) {
+        uint64_t field = pop(stack);
+        COUNT(searched_fields, 1);
+        uint64_t fields[4];
+        int m = SUFFIX(owned_neighbours)(b, field, p, fields);
+        for (int j = 0; j < m; j++) {
+            if (MARK_AT(b, fields[j]) != done) {
+                set_node(u, fields[j], set);
+                SET_MARK(b, fields[j], done);
+                push(stack, fields[j]);
+            }
+        }
+    }
+}
+
+/** @brief Przeszukuje obszar danego gracza jednocześnie z kilku pól.
+ * Przeszukiwania (DFS) z kolejnych pól startowych wykonują kroki
+ * na zmianę, a pola odwiedzone przez i-te z nich dostają znacznik
+ * first + i. Przeszukiwania, które się spotkały, należą do jednej części.
+ * Kończy, gdy została co najwyżej jedna niezakończona część albo części
+ * jest już więcej, niż dopuszczono. Część, która się odłączyła, zostaje
+ * więc przejrzana w czasie proporcjonalnym do jej rozmiaru, niezależnie
+ * od rozmiaru reszty. Stosy przeszukiwań zostają w @p b->stacks.
+ * @param[in, out] b - plansza gry
+ * @param[in] sources - pola startowe należące do danego gracza
+ * @param[in] n - liczba pól startowych (od 1 do 4)
+ * @param[in] p - nr danego gracza
+ * @param[in] first - pierwszy z @p n zarezerwowanych znaczników
+ * @param[in] max_parts - dopuszczalna liczba części
+ * @param[out] joined - grupy, z którymi połączyły się kolejne
+ * przeszukiwania
+ * @param[out] finished - liczba zakończonych części
+ * @return liczba części, większa od @p max_parts, jeśli przeszukiwanie
+ * przerwano
+ */
+static uint64_t SUFFIX(flood)(Board *b, const uint64_t sources[4], int n,
+                              uint32_t p, uint32_t first, uint64_t max_parts,
+                              int joined[4], int *finished) {
+    Stack *stacks = b->stacks;
+    for (int i = 0; i < n; i++) {
+        joined[i] = i;
+        clear(&stacks[i]);
+        // Powtórzone pole startowe od razu należy do tej samej części.
+        uint32_t mark = MARK_AT(b, sources[i]);
+        if (mark >= first && mark < first + i) {
+            joined[i] = joined_group(joined, mark - first);
+        } else {
+            SET_MARK(b, sources[i], first + i);
+            push(&stacks[i], sources[i]);
+        }
+    }
+
+    int active = count_parts(joined, stacks, n, finished);
+    while (active > 1 && (uint64_t) *finished + 1 <= max_parts &&
+           !b->failed) {
+        for (int i = 0; i < n && active > 1; i++) {
+            if (empty(&stacks[i])) { continue; }
+            uint64_t field = pop(&stacks[i]);
+            COUNT(searched_fields, 1);
+            bool merged = false;
+            uint64_t fields[4];
+            int m = SUFFIX(owned_neighbours)(b, field, p, fields);
+            for (int j = 0; j < m; j++) {
+                uint32_t mark = MARK_AT(b, fields[j]);
+                if (mark >= first) {
+                    int mine = joined_group(joined, i);
+                    int other = joined_group(joined, mark - first);
+                    if (mine != other) {
+                        joined[other] = mine;
+                        merged = true;
+                    }
+                } else {
+                    SET_MARK(b, fields[j], first + i);
+                    push(&stacks[i], fields[j]);
+                }
+            }
+            if (merged || empty(&stacks[i])) {
+                active = count_parts(joined, stacks, n, finished);
+                if ((uint64_t) *finished + (active > 0) > max_parts) {
+                    break;
+                }
+            }
+        }
+    }
+    return *finished + active;
+}
+
+static uint64_t SUFFIX(split_area)(Board *b, UnionFind *u, uint64_t f,
+                                   uint32_t p, uint64_t max_parts) {
+    uint64_t sources[4];
+    int n = SUFFIX(local_groups)(b, f, p, sources);
+    if (n <= 1) { return n; }
+    COUNT(area_splits, 1);
+
+    /* Pola odwiedzone przez przeszukiwanie i-tej grupy dostają znacznik
+     * first + i. Ostatni zarezerwowany znacznik oznacza pola przepięte
+     * już na nowy element.
+     */
+    uint32_t first = reserve_marks(b, n + 1);
+    if (first == 0) { return max_parts + 1; }
+    uint32_t done = first + n;
+    int joined[4];
+    int finished;
+    uint64_t parts = SUFFIX(flood)(b, sources, n, p, first, max_parts,
+                                   joined, &finished);
+    /* Pola niezakończonej części (odwiedzone lub nie) wskazują wciąż
+     * na elementy starego zbioru i tak zostaje. Zakończone części
+     * zostały przejrzane w całości, więc przepinamy je na nowe elementy.
+     */
+    if (parts <= max_parts && finished > 0) {
+        bool active_part[4] = {false, false, false, false};
+        for (int i = 0; i < n; i++) {
+            if (!empty(&b->stacks[i])) {
+                active_part[joined_group(joined, i)] = true;
+            }
+        }
+        for (int j = 0; j < n; j++) {
+            if (joined[j] == j && !active_part[j]) {
+                SUFFIX(relink_part)(b, u, sources[j], p, done);
+            }
+        }
+    }
+    return parts;
+}
+
+static char *SUFFIX(write_fields)(const Board *b, uint64_t f, uint32_t count,
+                                  char *out) {
+    for (uint32_t i = 0; i < count; i++, f = field_right(b, f)) {
+        out = write_number(out, CELL_AT(b, f));
+    }
+    return out;
+}
+
+static uint64_t SUFFIX(fields_width)(const Board *b, uint64_t f,
+                                     uint32_t count) {
+    uint64_t result = 0;
+    for (uint32_t i = 0; i < count; i++, f = field_right(b, f)) {
+        result += number_width(CELL_AT(b, f));
+    }
+    return result;
+}
+
+#undef CELL_BORDER
+#undef CELL_AT
+#undef MARK_AT
+#undef SET_MARK
@@ -0,0 +1,74 @@
+#include "changeLog.h"
+#include <string.h>
+
+/* Przyjęta przeze mnie początkowa liczba zmian, na które
+ * rezerwujemy miejsce w dzienniku.
+ */
+const uint64_t init_log = 64;
+
+ChangeLog new_ChangeLog(const Allocator *allocator) {
+    ChangeLog l;
+    l.entries = NULL;
+    l.first = 0;
+    l.size = 0;
+    l.capacity = 0;
+    l.enabled = false;
+    l.row_stamps = NULL;
+    l.stamp = 0;
+    l.failed = false;
+    l.allocator = allocator;
+    return l;
+}
+
+void del_ChangeLog(ChangeLog *l) {
+    safe_free(l->allocator, l->entries);
+    safe_free(l->allocator, l->row_stamps);
+    l->entries = NULL;
+    l->row_stamps = NULL;
+    l->size = 0;
+    l->capacity = 0;
+}
+
+bool grow_ChangeLog(ChangeLog *l) {
+    uint64_t capacity = l->capacity == 0 ? init_log : 2 * l->capacity;
+    Change *entries = safe_realloc(l->allocator, l->entries, capacity,
+                                   sizeof(Change));
+    if (entries == NULL) { return false; }
+    l->entries = entries;
+    l->capacity = capacity;
+    return true;
+}
+
+void drop_changes(ChangeLog *l, uint64_t checkpoint) {
+    if (checkpoint <= l->first) { return; }
+    uint64_t dropped = checkpoint - l->first;
+    memmove(l->entries, l->entries + dropped,
+            (l->size - dropped) * sizeof(Change));
+    l->first = checkpoint;
+    l->size -= dropped;
+}
+
+uint64_t dirty_rows(ChangeLog *l, uint64_t checkpoint, uint32_t height,
+                    uint32_t *rows, uint64_t max) {
+    if (l->row_stamps == NULL) {
+        l->row_stamps = safe_malloc(l->allocator, height, sizeof(uint64_t));
+        if (l->row_stamps == NULL) { return 0; }
+        for (uint32_t i = 0; i < height; i++) {
+            l->row_stamps[i] = 0;
+        }
+    }
+    /* Wiersz oznaczony bieżącym znacznikiem został już podany, więc
+     * tablicy znaczników nie trzeba czyścić między wywołaniami.
+     */
+    uint64_t stamp = ++l->stamp;
+    uint64_t how_many = 0;
+    for (uint64_t i = checkpoint - l->first; i < l->size; i++) {
+        uint32_t y = l->entries[i].y;
+        if (l->row_stamps[y] != stamp) {
+            l->row_stamps[y] = stamp;
+            if (how_many < max) { rows[how_many] = y; }
+            how_many++;
+        }
+    }
+    return how_many;
+}
@@ -0,0 +1,126 @@
+/** @file
+ * Interfejs dziennika zmian pól planszy.
+ * Dziennik zapamiętuje kolejne zmiany właścicieli pól, dzięki czemu
+ * klient wyświetlający planszę może pobrać tylko zmiany od ostatniego
+ * odświeżenia zamiast opisu całej planszy. Zmiany numerowane są
+ * kolejno od zera, a punktem kontrolnym jest numer pierwszej zmiany,
+ * która jeszcze nie nastąpiła. Dziennik jest wyłączony, dopóki
+ * klient nie poprosi o punkt kontrolny, więc gra bez klientów
+ * nie płaci za zapamiętywanie zmian.
+ */
+
+#ifndef CHANGELOG_H
+#define CHANGELOG_H
+
+#include "malloc.h"
+#include <stdbool.h>
+
+/**
+ * Struktura opisująca zmianę właściciela pola.
+ */
+struct change {
+    /*@{*/
+    uint32_t x; /**< numer kolumny pola */
+    uint32_t y; /**< numer wiersza pola */
+    uint32_t previous; /**< poprzedni właściciel pola (0 - pole wolne) */
+    uint32_t current; /**< nowy właściciel pola (0 - pole wolne) */
+    /*@{*/
+};
+/**
+ * Typ Change - alias na struct change.
+ */
+typedef struct change Change;
+
+/**
+ * Struktura przechowująca dziennik zmian.
+ * Zmiany przechowywane są w tablicy powiększanej dwukrotnie, gdy brakuje
+ * w niej miejsca. Zmiany starsze niż najstarszy potrzebny punkt kontrolny
+ * można usunąć (@ref drop_changes).
+ */
+struct changeLog {
+    /*@{*/
+    Change *entries; /**< zapamiętane zmiany, od najstarszej */
+    uint64_t first; /**< numer najstarszej zapamiętanej zmiany */
+    uint64_t size; /**< liczba zapamiętanych zmian */
+    uint64_t capacity; /**< liczba zmian, na które jest miejsce */
+    bool enabled; /**< czy zmiany są zapamiętywane */
+    uint64_t *row_stamps; /**< znaczniki wierszy, alokowane przy pierwszym
+                           * wyznaczaniu zmienionych wierszy */
+    uint64_t stamp; /**< ostatnia użyta wartość znacznika wierszy */
+    bool failed; /**< czy nie udało się zapamiętać którejś zmiany */
+    const Allocator *allocator; /**< alokator pamięci lub NULL */
+    /*@{*/
+};
+/**
+ * Typ ChangeLog - alias na struct changeLog.
+ */
+typedef struct changeLog ChangeLog;
+
+/** @brief Tworzy nowy, wyłączony dziennik zmian.
+ * @param[in] allocator - alokator pamięci lub NULL (funkcje biblioteki
+ * standardowej), musi istnieć tak długo jak struktura
+ * @return Nowy pusty dziennik.
+ */
+ChangeLog new_ChangeLog(const Allocator *allocator);
+
+/** @brief Usuwa dziennik zmian.
+ * Zwalnia pamięć zaalokowaną na zmiany i znaczniki wierszy.
+ * @param[in, out] l - wskaźnik na dziennik
+ */
+void del_ChangeLog(ChangeLog *l);
+
+/** @brief Powiększa tablicę zmian w dzienniku.
+ * Wywoływana przez @ref record_change, gdy brakuje miejsca.
+ * @param[in, out] l - wskaźnik na dziennik
+ * @return wartość @p true, jeśli udało się powiększyć tablicę, @p false,
+ * jeśli nie udało się zaalokować pamięci - wtedy dziennik pozostaje
+ * bez zmian.
+ */
+bool grow_ChangeLog(ChangeLog *l);
+
+/** @brief Podaje numer następnej zmiany.
+ * @param[in] l - wskaźnik na dziennik
+ * @return liczba zmian zapisanych w dzienniku od jego utworzenia
+ */
+static inline uint64_t next_change(const ChangeLog *l) {
+    return l->first + l->size;
+}
+
+/** @brief Zapisuje zmianę w dzienniku, jeśli dziennik jest włączony.
+ * @param[in, out] l - wskaźnik na dziennik
+ * @param[in] c - zmiana
+ * Jeśli nie udało się zaalokować pamięci, pomija zmianę i zapamiętuje błąd
+ * w polu @p failed.
+ */
+static inline void record_change(ChangeLog *l, Change c) {
+    if (!l->enabled) { return; }
+    if (l->size == l->capacity && !grow_ChangeLog(l)) {
+        l->failed = true;
+        return;
+    }
+    l->entries[l->size++] = c;
+}
+
+/** @brief Usuwa z dziennika zmiany sprzed punktu kontrolnego.
+ * @param[in, out] l - wskaźnik na dziennik
+ * @param[in] checkpoint - punkt kontrolny, nie większy od
+ * @ref next_change
+ */
+void drop_changes(ChangeLog *l, uint64_t checkpoint);
+
+/** @brief Wyznacza wiersze, w których zmieniły się pola od punktu
+ * kontrolnego. Każdy wiersz podawany jest raz, w kolejności pierwszej
+ * zmiany w tym wierszu.
+ * @param[in, out] l - wskaźnik na dziennik
+ * @param[in] checkpoint - punkt kontrolny, nie mniejszy od numeru
+ * najstarszej zapamiętanej zmiany i nie większy od @ref next_change
+ * @param[in] height - liczba wierszy planszy
+ * @param[out] rows - tablica, w której zapisujemy numery wierszy
+ * @param[in] max - rozmiar tablicy @p rows
+ * @return liczba zmienionych wierszy (zapisywanych jest co najwyżej
+ * @p max pierwszych) lub zero, jeśli nie udało się zaalokować pamięci.
+ */
+uint64_t dirty_rows(ChangeLog *l, uint64_t checkpoint, uint32_t height,
+                    uint32_t *rows, uint64_t max);
+
+#endif //CHANGELOG_H
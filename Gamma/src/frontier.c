@@ -0,0 +1,165 @@
+#include "frontier.h"
+#include "malloc.h"
+
+/** @brief Ustawia bit pola w zbiorze.
+ * @param[in, out] set - zbiór
+ * @param[in] f - numer pola
+ * @param[in] value - nowa wartość bitu
+ */
+static inline void set_bit(uint64_t *set, uint64_t f, bool value) {
+    uint64_t mask = (uint64_t) 1 << (f % 64);
+    if (value) { set[f / 64] |= mask; }
+    else { set[f / 64] &= ~mask; }
+}
+
+/** @brief Przepisuje zbiór pól małej planszy do zbioru struktury.
+ * @param[in] fr - wskaźnik na strukturę
+ * @param[out] set - zbiór struktury
+ * @param[in] s - zbiór pól planszy
+ * @return zbiór struktury
+ */
+static uint64_t *copy_bitboard(const Frontier *fr, uint64_t *set,
+                               const Bitboard *s) {
+    for (uint64_t i = 0; i < fr->words; i++) {
+        set[i] = s->words[i];
+    }
+    return set;
+}
+
+/** @brief Alokuje pusty zbiór pól.
+ * @param[in] fr - wskaźnik na strukturę
+ * @return nowy zbiór lub NULL, jeśli nie udało się zaalokować pamięci
+ */
+static uint64_t *new_set(Frontier *fr) {
+    uint64_t *set = safe_malloc(fr->allocator, fr->words, sizeof(uint64_t));
+    if (set == NULL) {
+        fr->failed = true;
+        return NULL;
+    }
+    for (uint64_t i = 0; i < fr->words; i++) {
+        set[i] = 0;
+    }
+    return set;
+}
+
+Frontier new_Frontier(const Board *b, uint32_t players,
+                      const Allocator *allocator) {
+    Frontier fr;
+    fr.players = NULL;
+    fr.free = NULL;
+    fr.number_of_players = players;
+    fr.words = (board_size(b) + 63) / 64;
+    fr.used = false;
+    fr.failed = false;
+    fr.allocator = allocator;
+    return fr;
+}
+
+void del_Frontier(Frontier *fr) {
+    if (fr->players != NULL) {
+        for (uint32_t i = 0; i <= fr->number_of_players; i++) {
+            safe_free(fr->allocator, fr->players[i]);
+        }
+    }
+    safe_free(fr->allocator, fr->players);
+    safe_free(fr->allocator, fr->free);
+    fr->players = NULL;
+    fr->free = NULL;
+    fr->used = false;
+}
+
+const uint64_t *player_frontier(Frontier *fr, const Board *b, uint32_t p) {
+    if (fr->players == NULL) {
+        fr->players = safe_malloc(fr->allocator,
+                                  (uint64_t) fr->number_of_players + 1,
+                                  sizeof(uint64_t *));
+        if (fr->players == NULL) {
+            fr->failed = true;
+            return NULL;
+        }
+        for (uint32_t i = 0; i <= fr->number_of_players; i++) {
+            fr->players[i] = NULL;
+        }
+    }
+    if (has_bitboards(b)) {
+        if (fr->players[p] == NULL) { fr->players[p] = new_set(fr); }
+        if (fr->players[p] == NULL) { return NULL; }
+        // Wolne pola przyległe to wolni sąsiedzi pól gracza.
+        Bitboard adjacent = bitboard_grow(&b->owned[p], &b->owned[0],
+                                          b->stride);
+        return copy_bitboard(fr, fr->players[p], &adjacent);
+    }
+    if (fr->players[p] == NULL) {
+        fr->players[p] = new_set(fr);
+        if (fr->players[p] == NULL) { return NULL; }
+        for (uint32_t x = 0; x < b->height; x++) {
+            for (uint32_t y = 0; y < b->width; y++) {
+                uint64_t f = field_index(b, x, y);
+                if (get_field(b, f) == 0 && has_adjacent(b, f, p)) {
+                    set_bit(fr->players[p], f, true);
+                }
+            }
+        }
+        fr->used = true;
+    }
+    return fr->players[p];
+}
+
+const uint64_t *free_fields(Frontier *fr, const Board *b) {
+    if (has_bitboards(b)) {
+        if (fr->free == NULL) { fr->free = new_set(fr); }
+        if (fr->free == NULL) { return NULL; }
+        return copy_bitboard(fr, fr->free, &b->owned[0]);
+    }
+    if (fr->free == NULL) {
+        fr->free = new_set(fr);
+        if (fr->free == NULL) { return NULL; }
+        for (uint32_t x = 0; x < b->height; x++) {
+            for (uint32_t y = 0; y < b->width; y++) {
+                uint64_t f = field_index(b, x, y);
+                if (get_field(b, f) == 0) { set_bit(fr->free, f, true); }
+            }
+        }
+        fr->used = true;
+    }
+    return fr->free;
+}
+
+/** @brief Podaje zbiór gracza, jeśli został zbudowany.
+ * @param[in] fr - wskaźnik na strukturę
+ * @param[in] p - wartość pola planszy
+ * @return zbiór gracza lub NULL, jeśli @p p nie jest numerem gracza
+ * albo jego zbiór nie został zbudowany
+ */
+static uint64_t *built_frontier(const Frontier *fr, uint32_t p) {
+    if (fr->players == NULL || p == 0 || p > fr->number_of_players) {
+        return NULL;
+    }
+    return fr->players[p];
+}
+
+void update_frontier(Frontier *fr, const Board *b, uint64_t f,
+                     uint32_t previous, uint32_t current) {
+    if (!fr->used) { return; }
+    if (fr->free != NULL) { set_bit(fr->free, f, current == 0); }
+    /* Zmiana pola zmienia jego przynależność do zbiorów właścicieli pól
+     * sąsiednich, a wolnym polom sąsiednim może zmienić przyległość
+     * tylko dla poprzedniego i nowego właściciela pola.
+     */
+    uint32_t owners[2] = {previous, current};
+    uint64_t neighbours[4];
+    adjacent_fields(b, f, neighbours);
+    for (int i = 0; i < 4; i++) {
+        uint32_t owner = get_field(b, neighbours[i]);
+        uint64_t *set = built_frontier(fr, owner);
+        if (set != NULL) { set_bit(set, f, current == 0); }
+        if (owner != 0) { continue; }
+        for (int j = 0; j < 2; j++) {
+            set = built_frontier(fr, owners[j]);
+            if (set != NULL) {
+                set_bit(set, neighbours[i],
+                        has_adjacent(b, neighbours[i], owners[j]));
+            }
+        }
+    }
+}
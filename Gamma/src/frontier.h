@@ -0,0 +1,88 @@
+/** @file
+ * Interfejs zbiorów pól, na których gracze mogą postawić pionek.
+ * Dla gracza, o którego ruchy ktoś zapytał, przechowywany jest zbiór
+ * (w postaci tablicy bitów indeksowanej numerami pól planszy) wolnych pól
+ * przyległych do jego pól, czyli tych, na których może postawić pionek,
+ * gdy ma już maksymalną liczbę obszarów. Osobno przechowywany jest zbiór
+ * wszystkich wolnych pól. Zbiory budowane są przy pierwszym zapytaniu
+ * i od tej pory aktualizowane po każdej zmianie pola planszy, a zmiana
+ * pola dotyczy tylko tego pola i jego sąsiadów. Gry, w których nikt nie
+ * pyta o zbiory, nie płacą za ich aktualizowanie. Na planszy ze zbiorami
+ * pól graczy zbiory nie są aktualizowane, tylko przepisywane przy każdym
+ * zapytaniu ze zbiorów planszy.
+ */
+
+#ifndef FRONTIER_H
+#define FRONTIER_H
+
+#include "board.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Struktura przechowująca zbiory pól dostępnych dla graczy.
+ */
+struct frontier {
+    /*@{*/
+    uint64_t **players; /**< zbiory wolnych pól przyległych dla kolejnych
+                         * graczy, NULL dla graczy, o których nie pytano */
+    uint64_t *free; /**< zbiór wolnych pól lub NULL, jeśli nie pytano */
+    uint32_t number_of_players; /**< liczba graczy */
+    uint64_t words; /**< liczba słów jednego zbioru */
+    bool used; /**< czy jakikolwiek zbiór został zbudowany */
+    bool failed; /**< czy nie udało się zbudować któregoś zbioru */
+    const Allocator *allocator; /**< alokator pamięci lub NULL */
+    /*@{*/
+};
+/**
+ * Typ Frontier - alias na struct frontier.
+ */
+typedef struct frontier Frontier;
+
+/** @brief Tworzy strukturę bez żadnych zbudowanych zbiorów.
+ * @param[in] b - plansza gry
+ * @param[in] players - liczba graczy
+ * @param[in] allocator - alokator pamięci lub NULL (funkcje biblioteki
+ * standardowej), musi istnieć tak długo jak struktura
+ * @return Nowa struktura.
+ */
+Frontier new_Frontier(const Board *b, uint32_t players,
+                      const Allocator *allocator);
+
+/** @brief Usuwa strukturę.
+ * Zwalnia pamięć zaalokowaną na wszystkie zbiory.
+ * @param[in, out] fr - wskaźnik na strukturę
+ */
+void del_Frontier(Frontier *fr);
+
+/** @brief Podaje zbiór wolnych pól przyległych dla gracza.
+ * Buduje zbiór, przeglądając planszę, jeśli nie został jeszcze zbudowany.
+ * @param[in, out] fr - wskaźnik na strukturę
+ * @param[in] b - plansza gry
+ * @param[in] p - nr gracza
+ * @return tablica bitów, w której bit o numerze pola jest ustawiony, jeśli
+ * pole jest wolne i przyległe dla gracza, lub NULL, jeśli nie udało się
+ * zaalokować pamięci.
+ */
+const uint64_t *player_frontier(Frontier *fr, const Board *b, uint32_t p);
+
+/** @brief Podaje zbiór wolnych pól planszy.
+ * Buduje zbiór, przeglądając planszę, jeśli nie został jeszcze zbudowany.
+ * @param[in, out] fr - wskaźnik na strukturę
+ * @param[in] b - plansza gry
+ * @return tablica bitów, w której bit o numerze pola jest ustawiony, jeśli
+ * pole jest wolne, lub NULL, jeśli nie udało się zaalokować pamięci.
+ */
+const uint64_t *free_fields(Frontier *fr, const Board *b);
+
+/** @brief Aktualizuje zbudowane zbiory po zmianie właściciela pola.
+ * @param[in, out] fr - wskaźnik na strukturę
+ * @param[in] b - plansza gry, na której pole ma już nowego właściciela
+ * @param[in] f - numer zmienionego pola
+ * @param[in] previous - poprzedni właściciel pola (0 - pole wolne)
+ * @param[in] current - nowy właściciel pola (0 - pole wolne)
+ */
+void update_frontier(Frontier *fr, const Board *b, uint64_t f,
+                     uint32_t previous, uint32_t current);
+
+#endif //FRONTIER_H
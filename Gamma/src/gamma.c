@@ -1,71 +1,609 @@
 #include "gamma.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
 
-gamma_t *gamma_new(uint32_t width, uint32_t height,
-                   uint32_t players, uint32_t areas) {
+/**
+ * Rozmiar porcji, w których opis planszy zapisywany jest do pliku.
+ */
+#define CHUNK_SIZE 4096
+
+#ifdef GAMMA_STATS
+
+/**
+ * Pomiar wywołania funkcji gry: stan liczników wątku i czas
+ * na początku wywołania.
+ */
+struct probe {
+    /*@{*/
+    uint64_t searched_fields; /**< pola odwiedzone przez przeszukiwania */
+    uint64_t area_splits; /**< podziały obszaru */
+    uint64_t allocations; /**< alokacje */
+    uint64_t allocated_bytes; /**< zaalokowane bajty */
+    uint64_t start; /**< czas rozpoczęcia w nanosekundach */
+    /*@{*/
+};
+
+/** @brief Podaje bieżący czas w nanosekundach.
+ * @return bieżący czas w nanosekundach
+ */
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/** @brief Rozpoczyna pomiar wywołania funkcji gry.
+ * @return pomiar wywołania
+ */
+static inline struct probe start_probe(void) {
+    struct probe probe;
+    probe.searched_fields = thread_counters.searched_fields;
+    probe.area_splits = thread_counters.area_splits;
+    probe.allocations = thread_counters.allocations;
+    probe.allocated_bytes = thread_counters.allocated_bytes;
+    probe.start = now_ns();
+    return probe;
+}
+
+/** @brief Kończy pomiar wywołania funkcji gry i przypisuje go grze.
+ * Funkcje gry nie wywołują innych mierzonych funkcji, więc przyrosty
+ * liczników wątku nie są przypisywane grze dwukrotnie.
+ * @param[in, out] g - wskaźnik na strukturę przechowującą stan gry
+ * lub NULL
+ * @param[in] probe - pomiar rozpoczęty na początku wywołania
+ * @param[in] function - mierzona funkcja
+ */
+static void finish_probe(gamma_t *g, const struct probe *probe,
+                         enum gamma_function function) {
+    uint64_t ns = now_ns() - probe->start;
+    if (g == NULL) { return; }
+    gamma_stats_t *s = &g->stats;
+    s->searched_fields += thread_counters.searched_fields -
+                          probe->searched_fields;
+    s->area_splits += thread_counters.area_splits - probe->area_splits;
+    s->allocations += thread_counters.allocations - probe->allocations;
+    s->allocated_bytes += thread_counters.allocated_bytes -
+                          probe->allocated_bytes;
+    s->calls[function]++;
+    s->ns[function] += ns;
+    if (ns > s->max_ns[function]) { s->max_ns[function] = ns; }
+}
+
+/** @brief Zlicza ruch zlecony grze.
+ * @param[in, out] g - wskaźnik na strukturę przechowującą stan gry
+ * lub NULL
+ * @param[in] golden - czy ruch był złotym ruchem
+ * @param[in] ok - czy ruch został wykonany
+ */
+static inline void count_move(gamma_t *g, bool golden, bool ok) {
+    if (g == NULL) { return; }
+    if (golden) {
+        ok ? g->stats.golden_accepted++ : g->stats.golden_rejected++;
+    } else {
+        ok ? g->stats.moves_accepted++ : g->stats.moves_rejected++;
+    }
+}
+
+/**
+ * Rozpoczyna pomiar wywołania funkcji gry.
+ */
+#define PROBE(name) struct probe name = start_probe()
+/**
+ * Kończy pomiar wywołania funkcji gry.
+ */
+#define FINISH(name, g, function) finish_probe(g, &name, function)
+/**
+ * Zlicza ruch zlecony grze.
+ */
+#define COUNT_MOVE(g, golden, ok) count_move(g, golden, ok)
+/**
+ * Zlicza wywołanie funkcji gry bez mierzenia czasu - dla funkcji
+ * działających w czasie stałym odczyt zegara kosztowałby więcej niż one.
+ */
+#define COUNT_CALL(g, function) \
+    ((g) != NULL ? (void) (g)->stats.calls[function]++ : (void) 0)
+
+#else
+
+/**
+ * Bez GAMMA_STATS wywołania nie są mierzone.
+ */
+#define PROBE(name) ((void) 0)
+/**
+ * Bez GAMMA_STATS wywołania nie są mierzone.
+ */
+#define FINISH(name, g, function) ((void) 0)
+/**
+ * Bez GAMMA_STATS ruchy nie są zliczane.
+ */
+#define COUNT_MOVE(g, golden, ok) ((void) 0)
+/**
+ * Bez GAMMA_STATS wywołania nie są zliczane.
+ */
+#define COUNT_CALL(g, function) ((void) 0)
+
+#endif
+
+/** @brief Sprawdza, czy gra ma własną arenę pamięci.
+ * Gra wczytana z obrazu ma zawsze własną arenę.
+ * @param[in] g - wskaźnik na strukturę przechowującą stan gry
+ * @return wartość @p true, jeśli cała pamięć gry poza stronami tablic
+ * leży w jej arenie, @p false, jeśli gra dostała alokator
+ */
+static inline bool owns_arena(const gamma_t *g) {
+    return g->allocator.data == &g->arena || g->allocator.data == &g->mapping;
+}
+
+/** @brief Ustawia alokator stron planszy i obszarów podzielonych na strony.
+ * Strony współdzielone z kopiami gry (patrz @ref gamma_clone) mogą
+ * przeżyć grę, która je zaalokowała, więc gra z własną areną pobiera je
+ * funkcjami biblioteki standardowej, a nie z areny.
+ * @param[in, out] g - wskaźnik na strukturę przechowującą stan gry,
+ * której tablice nie mają jeszcze żadnej strony
+ */
+static void set_page_allocator(gamma_t *g) {
+    const Allocator *a = owns_arena(g) ? NULL : &g->allocator;
+    g->board.cells.page_allocator = a;
+    g->regions.nodes.page_allocator = a;
+}
+
+/** @brief Tworzy strukturę przechowującą stan gry.
+ * Działa jak @ref gamma_new_with_allocator i @ref gamma_new_with_layout
+ * naraz.
+ * @param[in] width - szerokość planszy
+ * @param[in] height - wysokość planszy
+ * @param[in] players - liczba graczy
+ * @param[in] areas - maksymalna liczba obszarów gracza
+ * @param[in] allocator - alokator pamięci lub NULL
+ * @param[in] layout - układ pól planszy
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci lub któryś z parametrów jest niepoprawny.
+ */
+static gamma_t *new_game(uint32_t width, uint32_t height, uint32_t players,
+                         uint32_t areas, const gamma_allocator_t *allocator,
+                         gamma_layout_t layout) {
     if (width == 0 || height == 0 || players == 0 || areas == 0) {
         return NULL;
     }
+    // Numer gracza nie może być wartością ramki planszy.
+    if (players >= BORDER) { return NULL; }
 
-    gamma_t *g = NULL;
-    g = safe_malloc(g, sizeof(gamma_t));
-
-    g->board = safe_malloc(g->board, height * sizeof(uint32_t *));
-    for (uint32_t i = 0; i < height; i++) {
-        g->board[i] = safe_malloc(g->board[i], width * sizeof(uint32_t));
+    PROBE(probe);
+    /* Gra bez alokatora dostaje własną arenę, w której leży też struktura
+     * gry. Arenę przenosimy do struktury, a alokator gry wskazuje już
+     * na tę kopię.
+     */
+    Arena arena = new_Arena();
+    Allocator own = arena_allocator(&arena);
+    gamma_t *g = safe_malloc(allocator != NULL ? allocator : &own, 1,
+                             sizeof(gamma_t));
+    if (g == NULL) {
+        del_Arena(&arena);
+        return NULL;
     }
-    for (uint32_t i = 0; i < height; i++) {
-        for (uint32_t j = 0; j < width; j++) {
-            g->board[i][j] = 0;
-        }
+    g->arena = arena;
+    g->allocator = allocator != NULL ? *allocator
+                                     : arena_allocator(&g->arena);
+    g->mapping.data = NULL;
+    g->mapping.size = 0;
+    g->mapping.base = g->allocator;
+
+    const Allocator *a = &g->allocator;
+    g->board = new_Board(width, height, players,
+                         layout == GAMMA_LAYOUT_TILES, a);
+    g->regions = new_UnionFind(board_size(&g->board), a);
+    set_page_allocator(g);
+    g->changes = new_ChangeLog(a);
+    g->journal = new_Journal(a);
+    g->frontier = new_Frontier(&g->board, players, a);
+    g->articulation = new_Articulation(a);
+    g->pieces = new_Stack(a);
+    g->previous = new_Stack(a);
+    g->found = new_Stack(a);
+    g->players = safe_malloc(a, (uint64_t) players + 1, sizeof(Player));
+    if (g->board.failed || g->regions.failed || g->players == NULL) {
+        gamma_delete(g);
+        return NULL;
     }
 
-    g->players = safe_malloc(g->players, (players + 1) * sizeof(Player));
+    g->hash = 0;
     for (uint32_t i = 1; i <= players; i++) {
         g->players[i] = new_Player();
+        g->hash ^= golden_key(i);
     }
+    g->table = NULL;
 
     g->width = width;
     g->height = height;
     g->number_of_players = players;
     g->areas = areas;
-    g->free = g->width * g->height;
+    g->free = (uint64_t) width * height;
+    gamma_stats_reset(g);
+    FINISH(probe, g, GAMMA_STAT_NEW);
     return g;
 }
 
+gamma_t *gamma_new(uint32_t width, uint32_t height,
+                   uint32_t players, uint32_t areas) {
+    return new_game(width, height, players, areas, NULL, GAMMA_LAYOUT_ROWS);
+}
+
+gamma_t *gamma_new_with_allocator(uint32_t width, uint32_t height,
+                                  uint32_t players, uint32_t areas,
+                                  const gamma_allocator_t *allocator) {
+    return new_game(width, height, players, areas, allocator,
+                    GAMMA_LAYOUT_ROWS);
+}
+
+gamma_t *gamma_new_with_layout(uint32_t width, uint32_t height,
+                               uint32_t players, uint32_t areas,
+                               gamma_layout_t layout) {
+    return new_game(width, height, players, areas, NULL, layout);
+}
+
 void gamma_delete(gamma_t *g) {
-    if (g != NULL) {
-        free(g->players);
-        for (uint32_t i = 0; i < g->height; i++) {
-            free(g->board[i]);
+    if (g == NULL) { return; }
+    // Strony planszy i obszarów mogą należeć też do kopii gry.
+    del_Board(&g->board);
+    del_UnionFind(&g->regions);
+    if (owns_arena(g)) {
+        // Pozostała pamięć gry, łącznie z jej strukturą, leży w arenie.
+        Arena arena = g->arena;
+        Mapping mapping = g->mapping;
+        del_Arena(&arena);
+        del_Mapping(&mapping);
+        return;
+    }
+    safe_free(&g->allocator, g->players);
+    del_ChangeLog(&g->changes);
+    del_Journal(&g->journal);
+    del_Frontier(&g->frontier);
+    del_Articulation(&g->articulation);
+    del(&g->pieces);
+    del(&g->previous);
+    del(&g->found);
+    Allocator allocator = g->allocator;
+    safe_free(&allocator, g);
+}
+
+/** @brief Sprawdza, czy ruchy są zapamiętywane do cofnięcia.
+ * @param[in] g - wskaźnik na strukturę przechowującą stan gry
+ * @return wartość @p true, jeśli ruchy są zapamiętywane,
+ * @p false w przeciwnym wypadku
+ */
+static inline bool keeps_history(const gamma_t *g) {
+    return g->regions.journal != NULL;
+}
+
+/** @brief Sprawdza, czy w grze zabrakło pamięci.
+ * Struktury gry, którym nie udało się zaalokować pamięci, zapamiętują
+ * błąd i dalej działają bez wychodzenia poza zaalokowaną pamięć, ale
+ * nie odpowiadają już stanowi gry. Taka gra nie przyjmuje już ruchów.
+ * @param[in] g - wskaźnik na strukturę przechowującą stan gry
+ * @return wartość @p true, jeśli którejś strukturze gry zabrakło pamięci,
+ * @p false w przeciwnym wypadku
+ */
+static bool out_of_memory(const gamma_t *g) {
+    bool failed = g->board.failed || g->regions.failed ||
+                  g->changes.failed || g->journal.failed ||
+                  g->frontier.failed || g->articulation.failed ||
+                  g->pieces.failed || g->previous.failed ||
+                  g->found.failed;
+    for (int i = 0; i < 4; i++) {
+        failed = failed || g->board.stacks[i].failed;
+    }
+    return failed;
+}
+
+/** @brief Zapisuje sekcje obrazu gry i zapamiętuje ich przesunięcia
+ * w nagłówku.
+ * @param[in] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in, out] w - struktura zapisująca obraz, za nagłówkiem
+ * @param[out] h - nagłówek obrazu
+ */
+static void write_snapshot(const gamma_t *g, SnapshotWriter *w,
+                           struct snapshot_header *h) {
+    const Board *b = &g->board;
+    const UnionFind *u = &g->regions;
+    uint64_t players = (uint64_t) g->number_of_players + 1;
+    h->player_table = write_section(w, g->players, players * sizeof(Player));
+    h->cells = is_paged(b)
+               ? write_pages(w, &b->cells)
+               : write_section(w, b->fields, board_size(b) * b->cell_size);
+    h->owned = has_bitboards(b)
+               ? write_section(w, b->owned, players * sizeof(Bitboard)) : 0;
+    h->nodes = u->node == NULL
+               ? write_pages(w, &u->nodes)
+               : write_section(w, u->node, board_size(b) * sizeof(uint64_t));
+    h->parents = write_section(w, u->parent, u->size * sizeof(uint64_t));
+    h->ranks = write_section(w, u->rank, u->size * sizeof(uint8_t));
+    h->pieces = write_section(w, g->pieces.elements,
+                              g->pieces.size * sizeof(uint64_t));
+    h->previous = write_section(w, g->previous.elements,
+                                g->previous.size * sizeof(uint64_t));
+}
+
+bool gamma_save(gamma_t *g, int fd) {
+    if (g == NULL || out_of_memory(g)) { return false; }
+    struct snapshot_header h;
+    memset(&h, 0, sizeof(h));
+    h.magic = SNAPSHOT_MAGIC;
+    h.version = SNAPSHOT_VERSION;
+    h.header_size = sizeof(h);
+    h.player_size = sizeof(Player);
+    h.page_bits = PAGE_BITS;
+    h.width = g->width;
+    h.height = g->height;
+    h.players = g->number_of_players;
+    h.areas = g->areas;
+    h.tiled = g->board.tiled;
+    h.cell_size = g->board.cell_size;
+    h.free = g->free;
+    h.hash = g->hash;
+    h.elements = g->regions.size;
+    /* Nagłówek poprzedza sekcje, więc ich przesunięcia wyznaczamy
+     * najpierw zapisem bez deskryptora.
+     */
+    SnapshotWriter layout = new_SnapshotWriter(-1);
+    write_bytes(&layout, &h, sizeof(h));
+    write_snapshot(g, &layout, &h);
+    SnapshotWriter w = new_SnapshotWriter(fd);
+    write_bytes(&w, &h, sizeof(h));
+    write_snapshot(g, &w, &h);
+    return !w.failed;
+}
+
+/** @brief Sprawdza nagłówek obrazu gry.
+ * @param[in] h - nagłówek obrazu
+ * @return wartość @p true, jeśli obraz został zapisany w tej wersji formatu
+ * na komputerze tego samego rodzaju, a parametry gry są poprawne,
+ * @p false w przeciwnym wypadku
+ */
+static bool valid_header(const struct snapshot_header *h) {
+    return h->magic == SNAPSHOT_MAGIC && h->version == SNAPSHOT_VERSION &&
+           h->header_size == sizeof(*h) && h->player_size == sizeof(Player) &&
+           h->page_bits == PAGE_BITS && h->width > 0 && h->height > 0 &&
+           h->players > 0 && h->players < BORDER && h->areas > 0 &&
+           h->tiled <= 1 && h->free <= (uint64_t) h->width * h->height;
+}
+
+/** @brief Podłącza do gry tablice z odwzorowanego obrazu.
+ * @param[in, out] g - gra bez tablic planszy, obszarów i graczy
+ * @param[in] h - nagłówek obrazu
+ * @return wartość @p true, jeśli obraz zawiera wszystkie tablice
+ * w odpowiednich rozmiarach, @p false w przeciwnym wypadku
+ */
+static bool map_snapshot(gamma_t *g, const struct snapshot_header *h) {
+    Board *b = &g->board;
+    UnionFind *u = &g->regions;
+    const Mapping *m = &g->mapping;
+    uint64_t players = (uint64_t) g->number_of_players + 1;
+    if (b->failed || u->failed || b->cell_size != h->cell_size) {
+        return false;
+    }
+    g->players = mapped_section(m, h->player_table, players * sizeof(Player));
+    if (g->players == NULL) { return false; }
+    if (is_paged(b)) {
+        if (!map_pages(m, h->cells, &b->cells) ||
+            !map_pages(m, h->nodes, &u->nodes)) {
+            return false;
         }
-        free(g->board);
-        free(g);
+    } else {
+        b->fields = mapped_section(m, h->cells, board_size(b) * b->cell_size);
+        u->node = mapped_section(m, h->nodes,
+                                 board_size(b) * sizeof(uint64_t));
+        if (b->fields == NULL || u->node == NULL) { return false; }
+    }
+    if (fits_bitboards(b)) {
+        b->owned = mapped_section(m, h->owned, players * sizeof(Bitboard));
+        if (b->owned == NULL) { return false; }
     }
+    if (h->elements > 0) {
+        u->parent = mapped_section(m, h->parents,
+                                   h->elements * sizeof(uint64_t));
+        u->rank = mapped_section(m, h->ranks, h->elements * sizeof(uint8_t));
+        if (u->parent == NULL || u->rank == NULL) { return false; }
+    }
+    u->size = h->elements;
+    u->capacity = h->elements;
+    uint64_t pieces = (uint64_t) h->width * h->height - h->free;
+    if (pieces > 0) {
+        g->pieces.elements = mapped_section(m, h->pieces,
+                                            pieces * sizeof(uint64_t));
+        g->previous.elements = mapped_section(m, h->previous,
+                                              pieces * sizeof(uint64_t));
+        if (g->pieces.elements == NULL || g->previous.elements == NULL) {
+            return false;
+        }
+    }
+    g->pieces.size = g->previous.size = pieces;
+    g->pieces.capacity = g->previous.capacity = pieces;
+    return true;
 }
 
-bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    if (g == NULL) { return false; }
+gamma_t *gamma_load(int fd) {
+    Mapping mapping = new_Mapping(fd);
+    if (mapping.data == NULL) { return NULL; }
+    const struct snapshot_header *h = (void *) mapping.data;
+    if (mapping.size < sizeof(*h) || !valid_header(h)) {
+        del_Mapping(&mapping);
+        return NULL;
+    }
+    Arena arena = new_Arena();
+    Allocator own = arena_allocator(&arena);
+    gamma_t *g = safe_malloc(&own, 1, sizeof(gamma_t));
+    if (g == NULL) {
+        del_Arena(&arena);
+        del_Mapping(&mapping);
+        return NULL;
+    }
+    /* Pamięć spoza obrazu gra pobiera z własnej areny, przez alokator
+     * odwzorowania, który nie zwalnia tablic obrazu.
+     */
+    g->arena = arena;
+    g->mapping = mapping;
+    g->allocator = mapping_allocator(&g->mapping,
+                                     arena_allocator(&g->arena));
+
+    const Allocator *a = &g->allocator;
+    g->board = new_bare_Board(h->width, h->height, h->players, h->tiled, a);
+    g->regions = new_bare_UnionFind(board_size(&g->board), a);
+    set_page_allocator(g);
+    g->changes = new_ChangeLog(a);
+    g->journal = new_Journal(a);
+    g->frontier = new_Frontier(&g->board, h->players, a);
+    g->articulation = new_Articulation(a);
+    g->pieces = new_Stack(a);
+    g->previous = new_Stack(a);
+    g->found = new_Stack(a);
+    g->number_of_players = h->players;
+    if (!map_snapshot(g, h)) {
+        gamma_delete(g);
+        return NULL;
+    }
+    g->table = NULL;
+    g->width = h->width;
+    g->height = h->height;
+    g->areas = h->areas;
+    g->free = h->free;
+    g->hash = h->hash;
+    gamma_stats_reset(g);
+    return g;
+}
+
+gamma_t *gamma_clone(gamma_t *g) {
+    if (g == NULL || out_of_memory(g)) { return NULL; }
+    PROBE(probe);
+    Arena arena = new_Arena();
+    Allocator own = arena_allocator(&arena);
+    bool arena_game = owns_arena(g);
+    gamma_t *c = safe_malloc(arena_game ? &own : &g->allocator, 1,
+                             sizeof(gamma_t));
+    if (c == NULL) {
+        del_Arena(&arena);
+        return NULL;
+    }
+    c->arena = arena;
+    c->allocator = arena_game ? arena_allocator(&c->arena) : g->allocator;
+    c->mapping.data = NULL;
+    c->mapping.size = 0;
+    c->mapping.base = c->allocator;
+
+    /* Strony gry bez własnej areny pochodzą od jej alokatora, a strony
+     * pozostałych gier - od funkcji biblioteki standardowej.
+     */
+    const Allocator *a = &c->allocator;
+    const Allocator *pages = arena_game ? NULL : a;
+    uint32_t players = g->number_of_players;
+    c->board = clone_Board(&g->board, players, a, pages);
+    c->regions = clone_UnionFind(&g->regions, board_size(&g->board), a,
+                                 pages);
+    c->changes = new_ChangeLog(a);
+    c->journal = new_Journal(a);
+    c->frontier = new_Frontier(&c->board, players, a);
+    c->articulation = new_Articulation(a);
+    c->pieces = new_Stack(a);
+    c->previous = new_Stack(a);
+    c->found = new_Stack(a);
+    c->players = safe_malloc(a, (uint64_t) players + 1, sizeof(Player));
+    for (uint64_t i = 0; i < g->pieces.size; i++) {
+        push(&c->pieces, g->pieces.elements[i]);
+        push(&c->previous, g->previous.elements[i]);
+    }
+    if (c->board.failed || c->regions.failed || c->players == NULL ||
+        c->pieces.failed || c->previous.failed) {
+        gamma_delete(c);
+        return NULL;
+    }
+    memcpy(c->players, g->players, ((size_t) players + 1) * sizeof(Player));
+
+    c->table = g->table;
+    c->width = g->width;
+    c->height = g->height;
+    c->number_of_players = players;
+    c->areas = g->areas;
+    c->free = g->free;
+    c->hash = g->hash;
+    gamma_stats_reset(c);
+    FINISH(probe, c, GAMMA_STAT_CLONE);
+    return c;
+}
+
+/** @brief Zapamiętuje statystyki gracza przed ich zmianą przez ruch.
+ * @param[in, out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] p - nr gracza
+ */
+static void remember_player(gamma_t *g, uint32_t p) {
+    if (!keeps_history(g)) { return; }
+    const Player *player = &g->players[p];
+    remember(&g->journal, AREAS, p, player->areas);
+    remember(&g->journal, OCCUPIED, p, player->occupied);
+    remember(&g->journal, ADJACENT_FREE, p, player->adjacent_free);
+    remember(&g->journal, GOLDEN, p, player->golden);
+    remember(&g->journal, LAST_PIECE, p, player->last);
+    remember(&g->journal, TAKEN, p, player->taken);
+}
+
+/** @brief Kończy ruch: aktualizuje hasz stanu gry i zapamiętuje zmianę
+ * pola planszy do cofnięcia.
+ * @param[in, out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] x - numer kolumny pola
+ * @param[in] y - numer wiersza pola
+ * @param[in] former - poprzedni właściciel pola (0 - pole wolne, w
+ * przeciwnym razie ruch był złotym ruchem)
+ * @param[in] player - nowy właściciel pola
+ */
+static void finish_move(gamma_t *g, uint32_t x, uint32_t y, uint32_t former,
+                        uint32_t player) {
+    if (keeps_history(g)) {
+        remember(&g->journal, CELL, field_index(&g->board, y, x), former);
+        remember(&g->journal, HASH, 0, g->hash);
+    }
+    g->hash ^= field_key(x, y, player);
+    if (former != 0) {
+        g->hash ^= field_key(x, y, former) ^ golden_key(player);
+    }
+    if (keeps_history(g)) {
+        remember(&g->journal, MOVE_END, x, y);
+        g->journal.moves++;
+    }
+}
+
+/** @brief Wykonuje ruch w istniejącej grze.
+ * Działa jak @ref gamma_move, ale zakłada, że @p g nie jest NULL-em.
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] player - numer gracza
+ * @param[in] x - numer kolumny
+ * @param[in] y - numer wiersza
+ * @return wartość @p true, jeśli ruch został wykonany, @p false w przeciwnym
+ * wypadku
+ */
+static bool play_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
     if (player == 0 || player > g->number_of_players) { return false; }
     if (x >= g->width || y >= g->height) { return false; }
-    if (g->board[y][x] != 0) { return false; }
+    uint64_t f = field_index(&g->board, y, x);
+    if (get_field(&g->board, f) != 0) { return false; }
 
     /* Sprawdzamy, jak zmieni się liczba obszarów nowego własciciela pola.
     * Jeśli po ruchu liczba obszarów przekroczy dopuszczalną, zwracamy false.
     */
-    uint64_t areas_before = count_adjacent_areas(g->board, y, x, player,
-                                                 g->width, g->height);
+    uint64_t areas_before = count_adjacent_sets(&g->board, &g->regions, f,
+                                                player);
     uint64_t potential_areas = g->players[player].areas - areas_before + 1;
     if (potential_areas > g->areas) {
         return false;
     }
-    g->players[player].areas = potential_areas;
     // W tym momencie wiemy już, że ruch jest poprawny.
+    remember_player(g, player);
+    g->players[player].areas = potential_areas;
 
     // Po zajęciu pola zmienia się takżę liczba wolnych pól przyległych.
-    uint64_t new_adjacent_free = count_adjacent_free(g->board, y, x, player,
-                                                     g->width, g->height);
+    uint64_t new_adjacent_free = count_adjacent_free(&g->board, f, player);
     g->players[player].adjacent_free += new_adjacent_free;
-    if (has_adjacent(g->board, y, x, player, g->width, g->height)) {
+    if (has_adjacent(&g->board, f, player)) {
         g->players[player].adjacent_free--;
     }
 
@@ -73,68 +611,84 @@ bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
      * odejmujemy je, jeśli to konieczne. Pilnujemy, żeby żadnemu
      * graczowi nie odjąć więcej niż 1 pola przyległego.
      */
-    uint32_t n1 = 0, n2 = 0, n3 = 0, n4 = 0;
-    if (x > 0) { n1 = g->board[y][x - 1]; }
-    if (x < g->width - 1) { n2 = g->board[y][x + 1]; }
-    if (y > 0) { n3 = g->board[y - 1][x]; }
-    if (y < g->height - 1) { n4 = g->board[y + 1][x]; }
-    if (n1 != 0 && n1 != player) {
-        g->players[n1].adjacent_free--;
-    }
-    if (n2 != 0 && n2 != player && n2 != n1) {
-        g->players[n2].adjacent_free--;
-    }
-    if (n3 != 0 && n3 != player && n3 != n2 && n3 != n1) {
-        g->players[n3].adjacent_free--;
-    }
-    if (n4 != 0 && n4 != player && n4 != n3 && n4 != n2 && n4 != n1) {
-        g->players[n4].adjacent_free--;
+    uint32_t owners[4];
+    int n = adjacent_owners(&g->board, f, player, owners);
+    for (int i = 0; i < n; i++) {
+        if (keeps_history(g)) {
+            remember(&g->journal, ADJACENT_FREE, owners[i],
+                     g->players[owners[i]].adjacent_free);
+        }
+        g->players[owners[i]].adjacent_free--;
     }
     /* Dopiero teraz przypisujemy nr gracza do pola, w przeciwnym
      * razie funkcje has_adjacent wywołane powyżej zawsze zwracałyby true.
      */
+    if (keeps_history(g)) {
+        remember(&g->journal, FREE_FIELDS, 0, g->free);
+    }
     g->players[player].occupied++;
     g->free--;
-    g->board[y][x] = player;
+    set_field(&g->board, f, player);
+    push(&g->pieces, f);
+    push(&g->previous, g->players[player].last);
+    g->players[player].last = g->pieces.size;
+    join_adjacent(&g->board, &g->regions, f, player);
+    update_frontier(&g->frontier, &g->board, f, 0, player);
+    invalidate_regions(&g->articulation, &g->board, &g->regions, f);
+    record_change(&g->changes, (Change) {x, y, 0, player});
+    finish_move(g, x, y, 0, player);
     return true;
 }
 
-bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    if (g == NULL) { return false; }
+/** @brief Wykonuje złoty ruch w istniejącej grze.
+ * Działa jak @ref gamma_golden_move, ale zakłada, że @p g nie jest NULL-em.
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] player - numer gracza
+ * @param[in] x - numer kolumny
+ * @param[in] y - numer wiersza
+ * @return wartość @p true, jeśli ruch został wykonany, @p false w przeciwnym
+ * wypadku
+ */
+static bool play_golden_move(gamma_t *g, uint32_t player,
+                             uint32_t x, uint32_t y) {
     if (player == 0 || player > g->number_of_players) { return false; }
     if (!g->players[player].golden) { return false; }
     if (x >= g->width || y >= g->height) { return false; }
-    if (g->board[y][x] == 0 || g->board[y][x] == player) { return false; }
-    uint32_t former = g->board[y][x];
+    uint64_t f = field_index(&g->board, y, x);
+    uint32_t former = get_field(&g->board, f);
+    if (former == 0 || former == player) { return false; }
 
     /* Sprawdzamy, jak zmieni się liczba obszarów byłego i nowego
      * właściciela pola. Pole chwilowo staje się puste, aby poprawnie
      * przeprowadzić wszystkie obliczenia. Jeśli po ruchu liczba obszarów
      * któregoś z graczy przekroczy dopuszczalną, oddajemy pole poprzedniemu
-     * właścicielowi i zwracamy false.
+     * właścicielowi i zwracamy false. Najpierw sprawdzamy nowego
+     * właściciela, bo to nic nie kosztuje, a podział obszaru byłego
+     * właściciela przerywamy, gdy tylko części jest za dużo.
      */
-    g->board[y][x] = 0;
-    uint64_t areas_before = count_adjacent_areas(g->board, y, x, player,
-                                                 g->width, g->height);
-    uint64_t former_areas_before = count_adjacent_areas(g->board, y, x,
-                                                        former, g->width,
-                                                        g->height);
+    set_field(&g->board, f, 0);
+    uint64_t areas_before = count_adjacent_sets(&g->board, &g->regions, f,
+                                                player);
     uint64_t potential_areas = g->players[player].areas - areas_before + 1;
-    uint64_t former_potential_areas = g->players[former].areas +
-                                      former_areas_before - 1;
-    if (potential_areas > g->areas || former_potential_areas > g->areas) {
-        g->board[y][x] = former;
+    if (potential_areas > g->areas) {
+        set_field(&g->board, f, former);
+        return false;
+    }
+    uint64_t max_parts = (uint64_t) g->areas - g->players[former].areas + 1;
+    uint64_t parts = split_area(&g->board, &g->regions, f, former, max_parts);
+    if (parts > max_parts) {
+        set_field(&g->board, f, former);
         return false;
     }
     // W tym momencie wiemy już, że ruch jest poprawny.
+    remember_player(g, player);
+    remember_player(g, former);
     g->players[player].areas = potential_areas;
-    g->players[former].areas = former_potential_areas;
+    g->players[former].areas = g->players[former].areas + parts - 1;
 
     // Nowy właściciel może zyskać pola przyległe, były może je stracić.
-    uint64_t adj_to_add = count_adjacent_free(g->board, y, x, player,
-                                              g->width, g->height);
-    uint64_t adj_to_delete = count_adjacent_free(g->board, y, x, former,
-                                                 g->width, g->height);
+    uint64_t adj_to_add = count_adjacent_free(&g->board, f, player);
+    uint64_t adj_to_delete = count_adjacent_free(&g->board, f, former);
     g->players[player].adjacent_free += adj_to_add;
     g->players[former].adjacent_free -= adj_to_delete;
 
@@ -144,55 +698,909 @@ bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
     g->players[player].occupied++;
     g->players[former].occupied--;
     g->players[player].golden = false;
-    g->board[y][x] = player;
+    g->players[player].taken = f;
+    set_field(&g->board, f, player);
+    join_adjacent(&g->board, &g->regions, f, player);
+    update_frontier(&g->frontier, &g->board, f, former, player);
+    invalidate_regions(&g->articulation, &g->board, &g->regions, f);
+    record_change(&g->changes, (Change) {x, y, former, player});
+    finish_move(g, x, y, former, player);
     return true;
 }
 
-uint64_t gamma_busy_fields(gamma_t *g, uint32_t player) {
-    if (g == NULL) { return 0; }
-    if (player == 0 || player > g->number_of_players) { return 0; }
-    return g->players[player].occupied;
+bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    PROBE(probe);
+    bool result = g != NULL && !out_of_memory(g) &&
+                  play_move(g, player, x, y) && !out_of_memory(g);
+    COUNT_MOVE(g, false, result);
+    FINISH(probe, g, GAMMA_STAT_MOVE);
+    return result;
 }
 
-uint64_t gamma_free_fields(gamma_t *g, uint32_t player) {
-    if (g == NULL) { return 0; }
-    if (player == 0 || player > g->number_of_players) { return 0; }
+bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    PROBE(probe);
+    bool result = g != NULL && !out_of_memory(g) &&
+                  play_golden_move(g, player, x, y) && !out_of_memory(g);
+    COUNT_MOVE(g, true, result);
+    FINISH(probe, g, GAMMA_STAT_GOLDEN_MOVE);
+    return result;
+}
+
+size_t gamma_move_batch(gamma_t *g, const move_t *moves, size_t n,
+                        bool *results) {
+    if (g == NULL || moves == NULL) { return 0; }
+    PROBE(probe);
+    size_t done = 0;
+    for (size_t i = 0; i < n; i++) {
+        const move_t *m = &moves[i];
+        bool ok = !out_of_memory(g) &&
+                  (m->golden ? play_golden_move(g, m->player, m->x, m->y)
+                             : play_move(g, m->player, m->x, m->y)) &&
+                  !out_of_memory(g);
+        if (results != NULL) { results[i] = ok; }
+        done += ok;
+        COUNT_MOVE(g, m->golden, ok);
+    }
+    FINISH(probe, g, GAMMA_STAT_MOVE_BATCH);
+    return done;
+}
+
+/** @brief Sprawdza, czy gra istnieje i gracz ma w niej poprawny numer.
+ * @param[in] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] player - numer gracza
+ * @return wartość @p true, jeśli gra istnieje i numer gracza jest
+ * poprawny, @p false w przeciwnym wypadku
+ */
+static inline bool valid_player(const gamma_t *g, uint32_t player) {
+    return g != NULL && player != 0 && player <= g->number_of_players;
+}
+
+/** @brief Podaje liczbę pól, jakie gracz może jeszcze zająć zwykłym
+ * ruchem, dla istniejącej gry i poprawnego gracza.
+ * @param[in] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] player - numer poprawnego gracza
+ * @return liczba pól, jakie gracz może zająć zwykłym ruchem
+ */
+static inline uint64_t count_free(const gamma_t *g, uint32_t player) {
     if (g->players[player].areas == g->areas) {
         return g->players[player].adjacent_free;
     }
     return g->free;
 }
 
-bool gamma_golden_possible(gamma_t *g, uint32_t player) {
-    if (g == NULL) { return false; }
-    if (player == 0 || player > g->number_of_players) { return false; }
+/** @brief Sprawdza, czy gracz może wykonać złoty ruch, dla istniejącej
+ * gry i poprawnego gracza.
+ * @param[in] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] player - numer poprawnego gracza
+ * @return wartość @p true, jeśli gracz jeszcze nie wykonał złotego ruchu
+ * i jakieś pole jest zajęte przez innego gracza, @p false w przeciwnym
+ * wypadku
+ */
+static inline bool golden_possible(const gamma_t *g, uint32_t player) {
     if (!g->players[player].golden) { return false; }
-    return g->width * g->height - (g->free + g->players[player].occupied) > 0;
+    uint64_t fields = (uint64_t) g->width * g->height;
+    return fields - (g->free + g->players[player].occupied) > 0;
+}
+
+uint64_t gamma_busy_fields(gamma_t *g, uint32_t player) {
+    uint64_t result = valid_player(g, player)
+                      ? g->players[player].occupied : 0;
+    COUNT_CALL(g, GAMMA_STAT_BUSY_FIELDS);
+    return result;
+}
+
+uint64_t gamma_free_fields(gamma_t *g, uint32_t player) {
+    uint64_t result = valid_player(g, player) ? count_free(g, player) : 0;
+    COUNT_CALL(g, GAMMA_STAT_FREE_FIELDS);
+    return result;
+}
+
+bool gamma_golden_possible(gamma_t *g, uint32_t player) {
+    bool result = valid_player(g, player) && golden_possible(g, player);
+    COUNT_CALL(g, GAMMA_STAT_GOLDEN_POSSIBLE);
+    return result;
+}
+
+/** @brief Sprawdza, czy prostokątny fragment leży na planszy.
+ * @param[in] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] x - numer pierwszej kolumny fragmentu
+ * @param[in] y - numer pierwszego wiersza fragmentu
+ * @param[in] width - liczba kolumn fragmentu
+ * @param[in] height - liczba wierszy fragmentu
+ * @return wartość @p true, jeśli fragment jest niepusty i leży
+ * na planszy, @p false w przeciwnym wypadku
+ */
+static bool valid_region(gamma_t *g, uint32_t x, uint32_t y,
+                         uint32_t width, uint32_t height) {
+    if (g == NULL || width == 0 || height == 0) { return false; }
+    if (x >= g->width || width > g->width - x) { return false; }
+    return y < g->height && height <= g->height - y;
+}
+
+/** @brief Zapisuje opis prostokątnego fragmentu planszy.
+ * Wiersze zapisywane są od ostatniego, jak w @ref gamma_board.
+ * @param[in] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] x - numer pierwszej kolumny fragmentu
+ * @param[in] y - numer pierwszego wiersza fragmentu
+ * @param[in] width - liczba kolumn fragmentu
+ * @param[in] height - liczba wierszy fragmentu
+ * @param[out] out - bufor mieszczący opis fragmentu
+ * @return wskaźnik na pierwszy znak za zapisanym opisem
+ */
+static char *write_region(gamma_t *g, uint32_t x, uint32_t y,
+                          uint32_t width, uint32_t height, char *out) {
+    for (uint32_t i = 0; i < height; i++) {
+        uint64_t row = field_index(&g->board, y + height - i - 1, x);
+        out = write_fields(&g->board, row, width, out);
+        *out++ = '\n';
+    }
+    return out;
+}
+
+/** @brief Zapisuje cały bufor do pliku.
+ * Ponawia zapis po częściowym zapisie i po przerwaniu przez sygnał.
+ * @param[in] fd - deskryptor pliku
+ * @param[in] buffer - zapisywane dane
+ * @param[in] size - liczba bajtów do zapisania
+ * @return wartość @p true, jeśli zapisano wszystkie dane,
+ * @p false w przeciwnym wypadku
+ */
+static bool write_all(int fd, const char *buffer, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd, buffer, size);
+        if (written < 0 && errno == EINTR) { continue; }
+        if (written <= 0) { return false; }
+        buffer += written;
+        size -= written;
+    }
+    return true;
+}
+
+/** @brief Zapisuje opis planszy w nowo zaalokowanym buforze.
+ * Działa jak @ref gamma_board, ale zakłada, że @p g nie jest NULL-em.
+ * @param[in] g - wskaźnik na strukturę przechowującą stan gry
+ * @return wskaźnik na zaalokowany bufor z opisem planszy lub NULL,
+ * jeśli nie udało się zaalokować pamięci
+ */
+static char *write_board(gamma_t *g) {
+    /* Długość opisu planszy wyznaczamy z liczby pól zajętych przez
+     * kolejnych graczy, więc bufor alokujemy raz, od razu w dokładnie
+     * potrzebnym rozmiarze, i wypełniamy go w jednym przebiegu.
+     */
+    uint64_t length = (uint64_t) g->width * g->height + g->height;
+    for (uint32_t p = 1; p <= g->number_of_players; p++) {
+        uint64_t occupied = g->players[p].occupied;
+        length += occupied * number_width(p) - occupied;
+    }
+    // Opis planszy zwalnia wywołujący, funkcją free.
+    char *result = safe_malloc(NULL, length + 1, sizeof(char));
+    if (result == NULL) { return NULL; }
+    *write_region(g, 0, 0, g->width, g->height, result) = '\0';
+    return result;
 }
 
 char *gamma_board(gamma_t *g) {
-    if (g == NULL) { return NULL; }
-    void *test = malloc(sizeof(struct stringBuilder));
-    if (test == NULL) { return NULL; }
-    free(test);
-    String s = newString();
-    bool trouble = false;
-    for (uint32_t i = 0; i < g->height && !trouble; i++) {
-        for (uint32_t j = 0; j < g->width && !trouble; j++) {
-            if (!append_number(s, g->board[g->height - i - 1][j])) {
-                trouble = true;
+    PROBE(probe);
+    char *result = g != NULL ? write_board(g) : NULL;
+    FINISH(probe, g, GAMMA_STAT_BOARD);
+    return result;
+}
+
+uint64_t gamma_board_region(gamma_t *g, uint32_t x, uint32_t y,
+                            uint32_t width, uint32_t height,
+                            char *buffer, uint64_t length) {
+    if (!valid_region(g, x, y, width, height)) { return 0; }
+    uint64_t result = height;
+    for (uint32_t i = 0; i < height; i++) {
+        result += fields_width(&g->board, field_index(&g->board, y + i, x),
+                               width);
+    }
+    if (buffer != NULL && result < length) {
+        *write_region(g, x, y, width, height, buffer) = '\0';
+    }
+    return result;
+}
+
+bool gamma_board_region_write(gamma_t *g, uint32_t x, uint32_t y,
+                              uint32_t width, uint32_t height, int fd) {
+    if (!valid_region(g, x, y, width, height)) { return false; }
+    char chunk[CHUNK_SIZE];
+    size_t used = 0;
+    for (uint32_t i = 0; i < height; i++) {
+        uint32_t row = y + height - i - 1;
+        uint32_t done = 0;
+        /* Do porcji dopisujemy tyle pól, ile na pewno się zmieści,
+         * a zapełnioną porcję zapisujemy do pliku.
+         */
+        while (done < width) {
+            uint32_t count = (CHUNK_SIZE - 1 - used) / MAX_NUMBER_WIDTH;
+            if (count > width - done) { count = width - done; }
+            if (count == 0) {
+                if (!write_all(fd, chunk, used)) { return false; }
+                used = 0;
+                continue;
             }
+            used = write_fields(&g->board,
+                                field_index(&g->board, row, x + done),
+                                count, chunk + used) - chunk;
+            done += count;
         }
-        if (!append(s, '\n')) {
-            trouble = true;
+        chunk[used++] = '\n';
+    }
+    return write_all(fd, chunk, used);
+}
+
+/** @brief Sprawdza, czy punkt kontrolny dotyczy zapamiętanych zmian.
+ * @param[in] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] checkpoint - punkt kontrolny
+ * @return wartość @p true, jeśli dziennik jest włączony i zawiera
+ * wszystkie zmiany od punktu kontrolnego, @p false w przeciwnym wypadku
+ */
+static bool valid_checkpoint(gamma_t *g, uint64_t checkpoint) {
+    if (g == NULL || !g->changes.enabled) { return false; }
+    return checkpoint >= g->changes.first &&
+           checkpoint <= next_change(&g->changes);
+}
+
+uint64_t gamma_checkpoint(gamma_t *g) {
+    if (g == NULL) { return 0; }
+    g->changes.enabled = true;
+    return next_change(&g->changes);
+}
+
+uint64_t gamma_changes(gamma_t *g, uint64_t checkpoint,
+                       Change *changes, uint64_t max) {
+    if (!valid_checkpoint(g, checkpoint)) { return 0; }
+    uint64_t result = next_change(&g->changes) - checkpoint;
+    const Change *from = g->changes.entries + (checkpoint - g->changes.first);
+    for (uint64_t i = 0; i < result && i < max; i++) {
+        changes[i] = from[i];
+    }
+    return result;
+}
+
+uint64_t gamma_dirty_rows(gamma_t *g, uint64_t checkpoint,
+                          uint32_t *rows, uint64_t max) {
+    if (!valid_checkpoint(g, checkpoint)) { return 0; }
+    return dirty_rows(&g->changes, checkpoint, g->height, rows, max);
+}
+
+void gamma_release_changes(gamma_t *g, uint64_t checkpoint) {
+    if (!valid_checkpoint(g, checkpoint)) { return; }
+    drop_changes(&g->changes, checkpoint);
+}
+
+void gamma_keep_history(gamma_t *g, bool keep) {
+    if (g == NULL) { return; }
+    if (!keep) { clear_Journal(&g->journal); }
+    g->regions.journal = keep ? &g->journal : NULL;
+}
+
+/** @brief Przywraca wartość zapamiętaną we wpisie dziennika ruchów.
+ * @param[in, out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] e - wpis dziennika, inny niż koniec ruchu
+ */
+static void restore(gamma_t *g, Entry e) {
+    switch (e.kind) {
+        case CELL: set_field(&g->board, e.index, e.value); break;
+        case NODE: write_node(&g->regions, e.index, e.value); break;
+        case PARENT: g->regions.parent[e.index] = e.value; break;
+        case RANK: g->regions.rank[e.index] = e.value; break;
+        case ELEMENTS: g->regions.size = e.value; break;
+        case AREAS: g->players[e.index].areas = e.value; break;
+        case OCCUPIED: g->players[e.index].occupied = e.value; break;
+        case ADJACENT_FREE: g->players[e.index].adjacent_free = e.value; break;
+        case GOLDEN: g->players[e.index].golden = e.value; break;
+        case LAST_PIECE: g->players[e.index].last = e.value; break;
+        case TAKEN: g->players[e.index].taken = e.value; break;
+        case FREE_FIELDS: g->free = e.value; break;
+        case HASH: g->hash = e.value; break;
+        default: break;
+    }
+}
+
+/** @brief Cofa ostatni zapamiętany ruch.
+ * Działa jak @ref gamma_undo, ale zakłada, że @p g nie jest NULL-em.
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @return wartość @p true, jeśli ruch został cofnięty, @p false
+ * w przeciwnym wypadku
+ */
+static bool undo_move(gamma_t *g) {
+    if (g->journal.moves == 0 || out_of_memory(g)) { return false; }
+    Journal *j = &g->journal;
+    /* Wpisy ponad znacznikiem końca ostatniego ruchu pochodzą z kompresji
+     * ścieżek w ruchach odrzuconych po nim. Kompresja zmienia tylko kształt
+     * drzew, ale cofnięcie połączenia zbiorów wymaga przywrócenia drzew
+     * dokładnie w takim stanie, w jakim je połączono, więc i te wpisy
+     * przywracamy.
+     */
+    while (j->entries[j->size - 1].kind != MOVE_END) {
+        restore(g, j->entries[--j->size]);
+    }
+    Entry end = j->entries[--j->size];
+    uint32_t x = end.index;
+    uint32_t y = end.value;
+    uint64_t f = field_index(&g->board, y, x);
+    uint32_t current = get_field(&g->board, f);
+    while (j->size > 0 && j->entries[j->size - 1].kind != MOVE_END) {
+        restore(g, j->entries[--j->size]);
+    }
+    j->moves--;
+    uint32_t restored = get_field(&g->board, f);
+    // Zwolnione pole zajęto ostatnim niecofniętym zwykłym ruchem.
+    if (restored == 0) {
+        pop(&g->pieces);
+        pop(&g->previous);
+    }
+    update_frontier(&g->frontier, &g->board, f, current, restored);
+    invalidate_regions(&g->articulation, &g->board, &g->regions, f);
+    record_change(&g->changes, (Change) {x, y, current, restored});
+    return true;
+}
+
+bool gamma_undo(gamma_t *g) {
+    PROBE(probe);
+    bool result = g != NULL && undo_move(g);
+    FINISH(probe, g, GAMMA_STAT_UNDO);
+    return result;
+}
+
+/** @brief Wylicza pola zbioru planszy w układzie kafelkowym w kolejności
+ * wierszy planszy.
+ * Słowo zbioru to jeden kafelek, a jego kolejne bajty to kolejne wiersze
+ * kafelka. Pasy kafelków przeglądamy wiersz po wierszu, pomijając pasy
+ * bez żadnego pola zbioru.
+ * @param[in] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] set - zbiór pól
+ * @param[in] callback - funkcja wywoływana dla kolejnych pól
+ * @param[in] data - dane przekazywane funkcji @p callback
+ * @return liczba wyliczonych pól
+ */
+static uint64_t tiled_fields(gamma_t *g, const uint64_t *set,
+                             field_callback_t callback, void *data) {
+    _Static_assert(2 * TILE_BITS == 6, "kafelek musi wypełniać słowo");
+    const uint64_t side = 1 << TILE_BITS;
+    uint64_t tiles = g->board.stride / 64;
+    uint64_t result = 0;
+    for (uint64_t band = 0; band < g->frontier.words; band += tiles) {
+        uint64_t any = 0;
+        for (uint64_t t = 0; t < tiles; t++) { any |= set[band + t]; }
+        if (any == 0) { continue; }
+        for (uint64_t row = 0; row < side; row++) {
+            for (uint64_t t = 0; t < tiles; t++) {
+                uint64_t bits = (set[band + t] >> (row * side)) &
+                                ((1 << side) - 1);
+                while (bits != 0) {
+                    uint64_t f = (band + t) * 64 + row * side +
+                                 __builtin_ctzll(bits);
+                    bits &= bits - 1;
+                    uint32_t x, y;
+                    field_position(&g->board, f, &y, &x);
+                    callback(x, y, data);
+                    result++;
+                }
+            }
         }
     }
-    if (trouble) {
-        free(s->word);
-        free(s);
-        return NULL;
+    return result;
+}
+
+/** @brief Wylicza pola, które gracz może zająć zwykłym ruchem.
+ * Działa jak @ref gamma_legal_moves, ale zakłada, że gra istnieje,
+ * a numer gracza jest poprawny.
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] player - numer poprawnego gracza
+ * @param[in] callback - funkcja wywoływana dla kolejnych pól
+ * @param[in] data - dane przekazywane funkcji @p callback
+ * @return liczba wyliczonych pól
+ */
+static uint64_t legal_moves(gamma_t *g, uint32_t player,
+                            field_callback_t callback, void *data) {
+    const uint64_t *set = g->players[player].areas == g->areas
+                          ? player_frontier(&g->frontier, &g->board, player)
+                          : free_fields(&g->frontier, &g->board);
+    if (set == NULL) { return 0; }
+    if (g->board.tiled) { return tiled_fields(g, set, callback, data); }
+    /* Przeglądamy zbiór słowami, więc puste fragmenty planszy kosztują
+     * jedno porównanie na 64 pola.
+     */
+    uint64_t result = 0;
+    for (uint64_t i = 0; i < g->frontier.words; i++) {
+        uint64_t word = set[i];
+        while (word != 0) {
+            uint64_t f = i * 64 + __builtin_ctzll(word);
+            word &= word - 1;
+            uint32_t x, y;
+            field_position(&g->board, f, &y, &x);
+            callback(x, y, data);
+            result++;
+        }
+    }
+    return result;
+}
+
+uint64_t gamma_legal_moves(gamma_t *g, uint32_t player,
+                           field_callback_t callback, void *data) {
+    PROBE(probe);
+    uint64_t result = valid_player(g, player) && callback != NULL
+                      ? legal_moves(g, player, callback, data) : 0;
+    FINISH(probe, g, GAMMA_STAT_LEGAL_MOVES);
+    return result;
+}
+
+uint64_t gamma_legal_count(gamma_t *g, uint32_t player) {
+    return gamma_free_fields(g, player);
+}
+
+/** @brief Porównuje pozycje pól dla funkcji qsort.
+ * Pozycja to numer wiersza pomnożony przez 2^32 plus numer kolumny.
+ * @param[in] a - wskaźnik na pierwszą pozycję
+ * @param[in] b - wskaźnik na drugą pozycję
+ * @return liczba ujemna, zero lub dodatnia, jeśli pierwsza pozycja
+ * poprzedza drugą w kolejności wierszy, jest jej równa lub po niej następuje
+ */
+static int compare_positions(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+/** @brief Zapamiętuje pole, jeśli gracz może je zająć złotym ruchem.
+ * Złoty ruch na pole gracza q jest dozwolony, jeśli nowy właściciel
+ * nie przekroczy limitu obszarów (liczymy jego zbiory sąsiadujące
+ * z polem) i q nie przekroczy go po rozpadzie obszaru pola na części.
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] player - numer poprawnego gracza
+ * @param[in] f - numer pola zajętego przez innego gracza
+ * @return wartość @p false, jeśli nie udało się zaalokować pamięci,
+ * @p true w przeciwnym wypadku
+ */
+static bool add_candidate(gamma_t *g, uint32_t player, uint64_t f) {
+    uint32_t owner = get_field(&g->board, f);
+    uint64_t joined = count_adjacent_sets(&g->board, &g->regions, f, player);
+    if (g->players[player].areas - joined + 1 > g->areas) { return true; }
+    uint64_t parts;
+    if (!split_parts(&g->articulation, &g->board, &g->regions, f, &parts)) {
+        return false;
+    }
+    if ((uint64_t) g->players[owner].areas + parts - 1 > g->areas) {
+        return true;
+    }
+    // Zapamiętujemy pozycję pola tak, by dało się je posortować.
+    uint32_t x, y;
+    field_position(&g->board, f, &y, &x);
+    push(&g->found, (uint64_t) y << 32 | x);
+    return !g->found.failed;
+}
+
+/** @brief Zapamiętuje pola przeciwników sąsiadujące z polami gracza,
+ * które gracz może zająć złotym ruchem.
+ * Pola gracza przeglądamy po jego liście, od @ref player::last,
+ * pomijając pola zabrane mu złotymi ruchami, i dokładamy pole, które
+ * sam zabrał. Pole przeciwnika sąsiadujące z kilkoma polami gracza
+ * zapamiętujemy kilka razy.
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] player - numer poprawnego gracza
+ * @param[in] first_only - czy zakończyć na pierwszym znalezionym polu
+ * @return wartość @p false, jeśli nie udało się zaalokować pamięci,
+ * @p true w przeciwnym wypadku
+ */
+static bool adjacent_candidates(gamma_t *g, uint32_t player,
+                                bool first_only) {
+    const Board *b = &g->board;
+    uint64_t next = g->players[player].last;
+    uint64_t f = g->players[player].taken;
+    bool own = f != 0 && get_field(b, f) == player;
+    while (own || next != 0) {
+        if (!own) {
+            f = g->pieces.elements[next - 1];
+            next = g->previous.elements[next - 1];
+            if (get_field(b, f) != player) { continue; }
+        }
+        own = false;
+        uint64_t neighbours[4];
+        adjacent_fields(b, f, neighbours);
+        for (int i = 0; i < 4; i++) {
+            uint32_t owner = get_field(b, neighbours[i]);
+            if (owner == 0 || owner == player || owner == border_value(b)) {
+                continue;
+            }
+            if (!add_candidate(g, player, neighbours[i])) { return false; }
+            if (first_only && g->found.size > 0) { return true; }
+        }
+    }
+    return true;
+}
+
+/** @brief Wylicza pola, które gracz może zająć złotym ruchem.
+ * Gracz poniżej limitu obszarów może zabrać pole z listy zajętych pól,
+ * a gracz z maksymalną liczbą obszarów - tylko pole sąsiadujące z jego
+ * polem, bo zajęcie innego utworzyłoby nowy obszar, więc wtedy
+ * przeglądamy tylko sąsiadów jego pól. Pola zgłaszane są dopiero po
+ * sprawdzeniu wszystkich (w kolejności wierszy, bez powtórzeń), więc przy
+ * braku pamięci funkcja @p callback nie jest wywoływana ani razu.
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] player - numer poprawnego gracza
+ * @param[in] callback - funkcja wywoływana dla kolejnych pól lub NULL
+ * @param[in] data - dane przekazywane funkcji @p callback
+ * @param[in] first_only - czy zakończyć na pierwszym znalezionym polu
+ * @return liczba wyliczonych pól lub zero, jeśli nie udało się zaalokować
+ * pamięci
+ */
+static uint64_t golden_candidates(gamma_t *g, uint32_t player,
+                                  field_callback_t callback, void *data,
+                                  bool first_only) {
+    if (!g->players[player].golden || out_of_memory(g)) { return 0; }
+    Stack *found = &g->found;
+    clear(found);
+    if (g->players[player].areas >= g->areas) {
+        if (!adjacent_candidates(g, player, first_only)) { return 0; }
+    } else {
+        for (uint64_t i = 0; i < g->pieces.size; i++) {
+            uint64_t f = g->pieces.elements[i];
+            if (get_field(&g->board, f) == player) { continue; }
+            if (!add_candidate(g, player, f)) { return 0; }
+            if (first_only && found->size > 0) { break; }
+        }
+    }
+    if (found->size > 1) {
+        qsort(found->elements, found->size, sizeof(uint64_t),
+              compare_positions);
+        uint64_t unique = 1;
+        for (uint64_t i = 1; i < found->size; i++) {
+            if (found->elements[i] != found->elements[unique - 1]) {
+                found->elements[unique++] = found->elements[i];
+            }
+        }
+        found->size = unique;
+    }
+    if (callback == NULL) { return found->size; }
+    for (uint64_t i = 0; i < found->size; i++) {
+        uint64_t position = found->elements[i];
+        callback(position & UINT32_MAX, position >> 32, data);
     }
-    char *result = s->word;
-    free(s);
+    return found->size;
+}
+
+/** @brief Sprawdza, czy gracz może wykonać jakikolwiek złoty ruch.
+ * Działa jak @ref gamma_golden_legal, ale zakłada, że numer gracza jest
+ * poprawny.
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] player - numer poprawnego gracza
+ * @return wartość @p true, jeśli gracz może wykonać złoty ruch, @p false
+ * w przeciwnym wypadku lub jeśli nie udało się zaalokować pamięci
+ */
+static bool golden_legal(gamma_t *g, uint32_t player) {
+    if (!g->players[player].golden || out_of_memory(g)) { return false; }
+    if (g->players[player].areas >= g->areas) {
+        return golden_candidates(g, player, NULL, NULL, true) > 0;
+    }
+    /* Zabranie pola, które nie jest punktem artykulacji (każdy obszar
+     * ma takie pole), nie zwiększa liczby obszarów przeciwnika, a gracz
+     * poniżej limitu może zająć dowolne pole.
+     */
+    for (uint32_t q = 1; q <= g->number_of_players; q++) {
+        if (q != player && g->players[q].occupied > 0) { return true; }
+    }
+    return false;
+}
+
+uint64_t gamma_golden_candidates(gamma_t *g, uint32_t player,
+                                 field_callback_t callback, void *data) {
+    PROBE(probe);
+    uint64_t result = valid_player(g, player) && callback != NULL
+                      ? golden_candidates(g, player, callback, data, false)
+                      : 0;
+    FINISH(probe, g, GAMMA_STAT_GOLDEN_CANDIDATES);
+    return result;
+}
+
+bool gamma_golden_legal(gamma_t *g, uint32_t player) {
+    PROBE(probe);
+    bool result = valid_player(g, player) && golden_legal(g, player);
+    FINISH(probe, g, GAMMA_STAT_GOLDEN_LEGAL);
     return result;
-}
\ No newline at end of file
+}
+
+uint64_t gamma_hash(gamma_t *g, uint32_t to_move) {
+    if (g == NULL) { return 0; }
+    return to_move == 0 ? g->hash : g->hash ^ turn_key(to_move);
+}
+
+void gamma_attach_table(gamma_t *g, TranspositionTable *table) {
+    if (g == NULL) { return; }
+    g->table = table;
+}
+
+void gamma_table_store(gamma_t *g, uint32_t to_move, uint64_t value) {
+    if (g == NULL || g->table == NULL) { return; }
+    store(g->table, gamma_hash(g, to_move), value);
+}
+
+bool gamma_table_probe(gamma_t *g, uint32_t to_move, uint64_t *value) {
+    if (g == NULL || g->table == NULL || value == NULL) { return false; }
+    return probe(g->table, gamma_hash(g, to_move), value);
+}
+
+/**
+ * Liczba losowań pola, po których rozgrywka losowa przestaje szukać ruchu
+ * na ślepo i wybiera go ze zbioru pól dostępnych dla gracza.
+ */
+#define PLAYOUT_TRIES 16
+
+/**
+ * Odwrotność prawdopodobieństwa, z jakim gracz w rozgrywce losowej
+ * wykonuje złoty ruch, choć może wykonać zwykły.
+ */
+#define GOLDEN_CHANCE 32
+
+/**
+ * Stan rozgrywki losowej.
+ */
+struct playout {
+    /*@{*/
+    uint64_t *cells; /**< wolne pola planszy w dowolnej kolejności */
+    uint64_t *position; /**< pozycje wolnych pól w tablicy @p cells */
+    bool *gave_up; /**< gracze, którzy nie znaleźli złotego ruchu */
+    uint64_t size; /**< liczba wolnych pól */
+    uint64_t random; /**< stan generatora liczb pseudolosowych */
+    /*@{*/
+};
+
+/** @brief Losuje liczbę generatorem xorshift64*.
+ * @param[in, out] pl - wskaźnik na stan rozgrywki losowej
+ * @param[in] n - liczba dodatnia
+ * @return liczba z przedziału [0, n)
+ */
+static inline uint64_t next_random(struct playout *pl, uint64_t n) {
+    uint64_t x = pl->random;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    pl->random = x;
+    return (x * 0x2545F4914F6CDD1DULL) % n;
+}
+
+/** @brief Usuwa pole z tablicy wolnych pól rozgrywki losowej.
+ * @param[in, out] pl - wskaźnik na stan rozgrywki losowej
+ * @param[in] f - numer wolnego pola
+ */
+static inline void take_cell(struct playout *pl, uint64_t f) {
+    uint64_t i = pl->position[f];
+    uint64_t last = pl->cells[--pl->size];
+    pl->cells[i] = last;
+    pl->position[last] = i;
+}
+
+/** @brief Losuje wolne pole sąsiadujące z polem gracza.
+ * Najpierw losuje wolne pola planszy, a jeśli żadne z nich nie sąsiaduje
+ * z polem gracza, wybiera pole ze zbioru pól dostępnych dla gracza.
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in, out] pl - wskaźnik na stan rozgrywki losowej
+ * @param[in] player - numer gracza
+ * @param[out] f - numer wylosowanego pola
+ * @return wartość @p true, jeśli pole zostało wylosowane, @p false, jeśli
+ * nie udało się zaalokować pamięci na zbiór pól dostępnych dla gracza
+ */
+static bool pick_adjacent(gamma_t *g, struct playout *pl, uint32_t player,
+                          uint64_t *f) {
+    for (int i = 0; i < PLAYOUT_TRIES; i++) {
+        *f = pl->cells[next_random(pl, pl->size)];
+        if (has_adjacent(&g->board, *f, player)) { return true; }
+    }
+    const uint64_t *set = player_frontier(&g->frontier, &g->board, player);
+    if (set == NULL) { return false; }
+    uint64_t k = next_random(pl, g->players[player].adjacent_free);
+    uint64_t i = 0;
+    while ((uint64_t) __builtin_popcountll(set[i]) <= k) {
+        k -= __builtin_popcountll(set[i++]);
+    }
+    uint64_t word = set[i];
+    while (k-- > 0) { word &= word - 1; }
+    *f = i * 64 + __builtin_ctzll(word);
+    return true;
+}
+
+/** @brief Wykonuje losowy zwykły ruch gracza.
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in, out] pl - wskaźnik na stan rozgrywki losowej
+ * @param[in] player - numer gracza
+ * @return wartość @p true, jeśli ruch został wykonany, @p false, jeśli
+ * gracz nie może wykonać zwykłego ruchu
+ */
+static bool random_move(gamma_t *g, struct playout *pl, uint32_t player) {
+    uint64_t f;
+    if (g->players[player].areas < g->areas) {
+        if (pl->size == 0) { return false; }
+        f = pl->cells[next_random(pl, pl->size)];
+    } else {
+        if (g->players[player].adjacent_free == 0 ||
+            !pick_adjacent(g, pl, player, &f)) {
+            return false;
+        }
+    }
+    uint32_t x, y;
+    field_position(&g->board, f, &y, &x);
+    play_move(g, player, x, y);
+    take_cell(pl, f);
+    return true;
+}
+
+/**
+ * Pole wybierane losowo spośród wyliczanych przez silnik.
+ */
+struct random_pick {
+    /*@{*/
+    struct playout *playout; /**< stan rozgrywki losowej */
+    uint64_t seen; /**< liczba dotychczas wyliczonych pól */
+    uint32_t x; /**< numer kolumny wybranego pola */
+    uint32_t y; /**< numer wiersza wybranego pola */
+    /*@{*/
+};
+
+/** @brief Wybiera pole z prawdopodobieństwem odwrotnym do liczby
+ * dotychczas wyliczonych pól, dzięki czemu po wyliczeniu wszystkich pól
+ * każde z nich jest wybrane z takim samym prawdopodobieństwem.
+ * @param[in] x - numer kolumny pola
+ * @param[in] y - numer wiersza pola
+ * @param[in, out] data - wskaźnik na strukturę @ref random_pick
+ */
+static void pick_field(uint32_t x, uint32_t y, void *data) {
+    struct random_pick *pick = data;
+    if (next_random(pick->playout, ++pick->seen) == 0) {
+        pick->x = x;
+        pick->y = y;
+    }
+}
+
+/** @brief Wykonuje losowy złoty ruch gracza.
+ * Najpierw próbuje złotych ruchów na losowe pola planszy. Jeśli żaden
+ * się nie powiedzie, a gracz nie może wykonać zwykłego ruchu, losuje pole
+ * spośród wszystkich pól, na które może wykonać złoty ruch. Gracz, dla
+ * którego takiego pola nie ma, nie próbuje już złotego ruchu do końca
+ * rozgrywki.
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in, out] pl - wskaźnik na stan rozgrywki losowej
+ * @param[in] player - numer gracza
+ * @param[in] forced - czy gracz nie może wykonać zwykłego ruchu
+ * @return wartość @p true, jeśli ruch został wykonany, @p false w przeciwnym
+ * wypadku
+ */
+static bool random_golden_move(gamma_t *g, struct playout *pl,
+                               uint32_t player, bool forced) {
+    for (int i = 0; i < PLAYOUT_TRIES; i++) {
+        uint32_t x = next_random(pl, g->width);
+        uint32_t y = next_random(pl, g->height);
+        if (play_golden_move(g, player, x, y)) { return true; }
+    }
+    if (!forced) { return false; }
+    struct random_pick pick = {pl, 0, 0, 0};
+    golden_candidates(g, player, pick_field, &pick, false);
+    if (pick.seen == 0) {
+        pl->gave_up[player] = true;
+        return false;
+    }
+    return play_golden_move(g, player, pick.x, pick.y);
+}
+
+/** @brief Wykonuje losowy ruch gracza w rozgrywce losowej.
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in, out] pl - wskaźnik na stan rozgrywki losowej
+ * @param[in] player - numer gracza
+ * @return wartość @p true, jeśli gracz wykonał ruch, @p false, jeśli nie
+ * mógł wykonać żadnego ruchu lub zabrakło pamięci
+ */
+static bool playout_turn(gamma_t *g, struct playout *pl, uint32_t player) {
+    const Player *p = &g->players[player];
+    bool stuck = p->areas < g->areas ? pl->size == 0 : p->adjacent_free == 0;
+    if (p->golden && !pl->gave_up[player]
+        && (stuck || next_random(pl, GOLDEN_CHANCE) == 0)
+        && random_golden_move(g, pl, player, stuck)) {
+        return true;
+    }
+    return random_move(g, pl, player) && !out_of_memory(g);
+}
+
+/** @brief Rozgrywa partię do końca losowymi ruchami.
+ * Działa jak @ref gamma_playout, ale zakłada, że gra istnieje, a numer
+ * gracza jest poprawny.
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] first - numer gracza, który wykonuje pierwszy ruch
+ * @param[in] seed - ziarno generatora liczb pseudolosowych
+ * @param[out] scores - liczby pól zajętych przez graczy na końcu partii
+ * @return wartość @p true, jeśli partia została rozegrana, @p false,
+ * jeśli nie udało się zaalokować pamięci
+ */
+static bool playout(gamma_t *g, uint32_t first, uint64_t seed,
+                    uint64_t *scores) {
+    if (out_of_memory(g)) { return false; }
+
+    struct playout pl;
+    /* Tablice zwalniamy w odwrotnej kolejności, więc arena gry może
+     * je po prostu zdjąć z końca bieżącej porcji.
+     */
+    const Allocator *a = &g->allocator;
+    pl.cells = safe_malloc(a, g->free + 1, sizeof(uint64_t));
+    pl.position = safe_malloc(a, board_size(&g->board), sizeof(uint64_t));
+    pl.gave_up = safe_malloc(a, (uint64_t) g->number_of_players + 1,
+                             sizeof(bool));
+    if (pl.cells == NULL || pl.position == NULL || pl.gave_up == NULL) {
+        safe_free(a, pl.gave_up);
+        safe_free(a, pl.position);
+        safe_free(a, pl.cells);
+        return false;
+    }
+    for (uint32_t i = 0; i <= g->number_of_players; i++) {
+        pl.gave_up[i] = false;
+    }
+    pl.size = 0;
+    for (uint32_t y = 0; y < g->height; y++) {
+        for (uint32_t x = 0; x < g->width; x++) {
+            uint64_t f = field_index(&g->board, y, x);
+            if (get_field(&g->board, f) == 0) {
+                pl.position[f] = pl.size;
+                pl.cells[pl.size++] = f;
+            }
+        }
+    }
+    // Stan generatora nie może być zerem.
+    pl.random = mix64(seed) | 1;
+
+    /* Rozgrywamy partię na samej grze, zapamiętując ruchy w dzienniku,
+     * a potem je cofamy. Zmiany pól rozgrywki nie trafiają do dziennika
+     * zmian - po jej zakończeniu plansza jest taka sama jak przed nią.
+     */
+    bool history = keeps_history(g);
+    bool changes = g->changes.enabled;
+    gamma_keep_history(g, true);
+    g->changes.enabled = false;
+    uint64_t moves = g->journal.moves;
+
+    uint32_t player = first;
+    uint32_t passes = 0;
+    while (passes < g->number_of_players) {
+        passes = playout_turn(g, &pl, player) ? 0 : passes + 1;
+        player = player % g->number_of_players + 1;
+    }
+    for (uint32_t i = 1; i <= g->number_of_players; i++) {
+        scores[i - 1] = g->players[i].occupied;
+    }
+
+    bool failed = out_of_memory(g);
+    while (g->journal.moves > moves && undo_move(g)) {}
+    g->changes.enabled = changes;
+    gamma_keep_history(g, history);
+    safe_free(a, pl.gave_up);
+    safe_free(a, pl.position);
+    safe_free(a, pl.cells);
+    return !failed;
+}
+
+bool gamma_playout(gamma_t *g, uint32_t first, uint64_t seed,
+                   uint64_t *scores) {
+    PROBE(probe);
+    bool result = valid_player(g, first) && scores != NULL &&
+                  playout(g, first, seed, scores);
+    FINISH(probe, g, GAMMA_STAT_PLAYOUT);
+    return result;
+}
+
+bool gamma_stats(gamma_t *g, gamma_stats_t *out) {
+#ifdef GAMMA_STATS
+    if (g == NULL || out == NULL) { return false; }
+    *out = g->stats;
+    return true;
+#else
+    (void) g;
+    (void) out;
+    return false;
+#endif
+}
+
+void gamma_stats_reset(gamma_t *g) {
+#ifdef GAMMA_STATS
+    if (g != NULL) { g->stats = (gamma_stats_t) {0}; }
+#else
+    (void) g;
+#endif
+}
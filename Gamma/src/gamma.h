@@ -9,23 +9,55 @@
 #ifndef GAMMA_H
 #define GAMMA_H
 
-#include "stringBuilder.h"
+#include "arena.h"
+#include "malloc.h"
+#include "printer.h"
 #include "player.h"
+#include "transposition.h"
+#include "zobrist.h"
+#include "articulation.h"
 #include "board.h"
+#include "changeLog.h"
+#include "frontier.h"
+#include "snapshot.h"
+#include "stats.h"
 
 /**
  * Struktura przechowująca stan gry.
  */
 struct gamma{
     /*@{*/
-    uint32_t **board; /**< reprezentacja stanu plaszy */
+    Board board; /**< reprezentacja stanu plaszy */
     Player *players; /**< statystyki graczy */
+    UnionFind regions; /**< obszary graczy jako zbiory rozłączne pól */
+    ChangeLog changes; /**< dziennik zmian pól planszy */
+    Journal journal; /**< dziennik ruchów, które można cofnąć */
+    Frontier frontier; /**< zbiory pól dostępnych dla graczy */
+    Articulation articulation; /**< podziały obszarów po zabraniu pól */
+    Stack pieces; /**< zajęte pola planszy w kolejności zajęcia */
+    Stack previous; /**< dla kolejnych pól z listy zajętych pól numer
+                     * (od 1) poprzedniego pola tego samego gracza na tej
+                     * liście lub 0 - pola gracza tworzą listę od
+                     * @ref player::last */
+    Stack found; /**< pozycje pól (numer wiersza razy 2^32 plus numer
+                  * kolumny) dozwolonych dla złotego ruchu, przed
+                  * zgłoszeniem ich wywołującemu */
     uint32_t width; /**< szerokość planszy */
     uint32_t height; /**< wysokosć planszy */
     uint32_t number_of_players; /**< liczba graczy */
     uint32_t areas; /**< maksymalna liczba obszarów,
                      * które może posiadać gracz */
     uint64_t free; /**< liczba wolnych pól na planszy */
+    uint64_t hash; /**< hasz Zobrista stanu gry (patrz @ref zobrist.h) */
+    TranspositionTable *table; /**< dołączona tablica transpozycji
+                                * lub NULL */
+    Allocator allocator; /**< alokator pamięci gry */
+    Arena arena; /**< arena pamięci gry, jeśli gra nie dostała alokatora */
+    Mapping mapping; /**< odwzorowany w pamięci obraz, z którego wczytano
+                      * grę (pole @p data jest NULL-em dla innych gier) */
+#ifdef GAMMA_STATS
+    gamma_stats_t stats; /**< statystyki pracy silnika dla tej gry */
+#endif
     /*@{*/
 };
 /**
@@ -33,9 +65,53 @@ struct gamma{
  */
 typedef struct gamma gamma_t;
 
+/**
+ * Typ gamma_allocator_t - alokator pamięci gry (patrz @ref Allocator).
+ */
+typedef struct allocator gamma_allocator_t;
+
+/**
+ * Układ pól planszy w pamięci (patrz @ref board.h).
+ */
+enum gamma_layout {
+    GAMMA_LAYOUT_ROWS, /**< wiersz po wierszu */
+    GAMMA_LAYOUT_TILES /**< kwadratowe kafelki 8x8 pól */
+};
+/**
+ * Typ gamma_layout_t - alias na enum gamma_layout.
+ */
+typedef enum gamma_layout gamma_layout_t;
+
+/**
+ * Struktura opisująca ruch (zwykły lub złoty).
+ */
+struct move {
+    /*@{*/
+    uint32_t player; /**< numer gracza */
+    uint32_t x; /**< numer kolumny pola */
+    uint32_t y; /**< numer wiersza pola */
+    bool golden; /**< czy ruch jest złotym ruchem */
+    /*@{*/
+};
+/**
+ * Typ move_t - alias na struct move.
+ */
+typedef struct move move_t;
+
+/**
+ * Typ funkcji wywoływanej dla kolejnych pól wyliczanych przez silnik.
+ * Przyjmuje numer kolumny i numer wiersza pola oraz dane przekazane
+ * przez wywołującego.
+ */
+typedef void (*field_callback_t)(uint32_t x, uint32_t y, void *data);
+
 /** @brief Tworzy strukturę przechowującą stan gry.
  * Alokuje pamięć na nową strukturę przechowującą stan gry.
  * Inicjuje tę strukturę tak, aby reprezentowała początkowy stan gry.
+ * Cała pamięć gry pochodzi z jej własnej areny (patrz @ref arena.h),
+ * zwalnianej naraz przez @ref gamma_delete. Wyjątkiem są strony bardzo
+ * dużej planszy, alokowane funkcją malloc, bo gra może je współdzielić
+ * z kopiami (patrz @ref gamma_clone).
  * @param[in] width   – szerokość planszy, liczba dodatnia,
  * @param[in] height  – wysokość planszy, liczba dodatnia,
  * @param[in] players – liczba graczy, liczba dodatnia,
@@ -47,6 +123,49 @@ typedef struct gamma gamma_t;
 gamma_t* gamma_new(uint32_t width, uint32_t height,
                     uint32_t players, uint32_t areas);
 
+/** @brief Tworzy strukturę przechowującą stan gry, której pamięć
+ * pochodzi od danego alokatora.
+ * Działa jak @ref gamma_new, ale całą pamięć gry, łącznie z samą
+ * strukturą, pobiera od alokatora i zwraca do niego. Alokator jest
+ * kopiowany, jego dane muszą jednak istnieć aż do usunięcia gry.
+ * Opis planszy z @ref gamma_board jest nadal alokowany funkcją malloc.
+ * @param[in] width     – szerokość planszy, liczba dodatnia,
+ * @param[in] height    – wysokość planszy, liczba dodatnia,
+ * @param[in] players   – liczba graczy, liczba dodatnia,
+ * @param[in] areas     – maksymalna liczba obszarów,
+ *                        jakie może zająć jeden gracz, liczba dodatnia,
+ * @param[in] allocator – alokator pamięci lub NULL (własna arena gry,
+ *                        jak w @ref gamma_new).
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci lub któryś z parametrów jest niepoprawny.
+ */
+gamma_t* gamma_new_with_allocator(uint32_t width, uint32_t height,
+                                  uint32_t players, uint32_t areas,
+                                  const gamma_allocator_t *allocator);
+
+/** @brief Tworzy strukturę przechowującą stan gry o danym układzie planszy.
+ * Działa jak @ref gamma_new, ale pozwala wybrać układ pól planszy
+ * w pamięci. W układzie kafelkowym pola sąsiednich wierszy leżą zwykle
+ * blisko siebie, co przyspiesza przeszukiwania dużych obszarów (złote
+ * ruchy dzielące obszary) na szerokich planszach, kosztem nieco
+ * droższego wyznaczania sąsiadów. Układ nie zmienia wyników funkcji,
+ * poza przebiegiem rozgrywek z @ref gamma_playout dla danego ziarna
+ * (pola są nadal losowane z tym samym rozkładem). Plansza zbyt duża,
+ * by trzymać ją w jednej tablicy (patrz @ref PAGING_THRESHOLD), ma
+ * zawsze układ wierszowy.
+ * @param[in] width   – szerokość planszy, liczba dodatnia,
+ * @param[in] height  – wysokość planszy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz, liczba dodatnia,
+ * @param[in] layout  – układ pól planszy.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci lub któryś z parametrów jest niepoprawny.
+ */
+gamma_t* gamma_new_with_layout(uint32_t width, uint32_t height,
+                               uint32_t players, uint32_t areas,
+                               gamma_layout_t layout);
+
 /** @brief Usuwa strukturę przechowującą stan gry.
  * Usuwa z pamięci strukturę wskazywaną przez @p g.
  * Nic nie robi, jeśli wskaźnik ten ma wartość NULL.
@@ -54,6 +173,57 @@ gamma_t* gamma_new(uint32_t width, uint32_t height,
  */
 void gamma_delete(gamma_t *g);
 
+/** @brief Zapisuje binarny obraz stanu gry do pliku.
+ * Obraz (patrz @ref snapshot.h) zawiera surowe tablice planszy, obszarów,
+ * zajętych pól i statystyk graczy, więc @ref gamma_load odtwarza z niego
+ * grę bez powtarzania ruchów. Obraz nie zawiera historii ruchów do cofnięcia,
+ * dziennika zmian planszy ani dołączonej tablicy transpozycji.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] fd      – deskryptor pliku otwartego do zapisu.
+ * @return Wartość @p true, jeśli zapisano cały obraz, a @p false,
+ * gdy któryś z parametrów jest niepoprawny, w grze zabrakło pamięci
+ * lub zapis się nie powiódł.
+ */
+bool gamma_save(gamma_t *g, int fd);
+
+/** @brief Wczytuje grę z binarnego obrazu stanu gry.
+ * Odwzorowuje plik w pamięci (mmap) i używa zapisanych w nim tablic
+ * w miejscu, więc czas wczytania nie zależy od rozmiaru planszy.
+ * Strony obrazu zmieniane przez ruchy są kopiowane przy pierwszym zapisie,
+ * a plik pozostaje niezmieniony. Deskryptor można zamknąć zaraz po
+ * wczytaniu, ale pliku nie wolno zmieniać, dopóki gra istnieje.
+ * Gra dostaje własną arenę pamięci, jak w @ref gamma_new, i zaczyna się
+ * bez historii ruchów. Sprawdzane są nagłówek i rozmiary sekcji obrazu,
+ * ale nie ich zawartość - obraz musi pochodzić z @ref gamma_save
+ * na komputerze tego samego rodzaju.
+ * @param[in] fd      – deskryptor pliku otwartego do odczytu.
+ * @return Wskaźnik na wczytaną strukturę lub NULL, gdy pliku nie udało się
+ * odwzorować, nie jest on obrazem gry zapisanym w tej wersji formatu
+ * albo nie udało się zaalokować pamięci.
+ */
+gamma_t* gamma_load(int fd);
+
+/** @brief Tworzy kopię stanu gry.
+ * Kopia jest niezależną grą: ruchy w niej nie zmieniają gry @p g i na
+ * odwrót. Plansza podzielona na strony (patrz @ref PAGING_THRESHOLD)
+ * i elementy obszarów wskazywane przez jej pola nie są kopiowane od razu -
+ * kopia współdzieli ich strony z grą @p g, a gra, która pierwsza zmienia
+ * współdzieloną stronę, dostaje jej własną kopię. Koszt utworzenia kopii
+ * i kilku ruchów w niej zależy więc od liczby zmienionych stron, a nie od
+ * rozmiaru planszy. Mniejsze plansze, statystyki graczy i drzewa obszarów
+ * są kopiowane w całości. Gry współdzielące strony mogą być przetwarzane
+ * przez różne wątki.
+ * Kopia pobiera pamięć od alokatora gry @p g (jego dane muszą istnieć aż
+ * do usunięcia kopii), a jeśli gra ma własną arenę (także gra wczytana
+ * z obrazu), dostaje własną arenę. Kopia zaczyna się
+ * bez historii ruchów i bez statystyk pracy silnika, a dołączona do gry
+ * tablica transpozycji jest dołączana także do kopii.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wskaźnik na kopię lub NULL, gdy wskaźnik @p g ma wartość NULL,
+ * w grze zabrakło pamięci lub nie udało się zaalokować pamięci na kopię.
+ */
+gamma_t* gamma_clone(gamma_t *g);
+
 /** @brief Wykonuje ruch.
  * Ustawia pionek gracza @p player na polu (@p x, @p y).
  * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
@@ -64,7 +234,9 @@ void gamma_delete(gamma_t *g);
  * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
  *                      @p height z funkcji @ref gamma_new.
  * @return Wartość @p true, jeśli ruch został wykonany, a @p false,
- * gdy ruch jest nielegalny lub któryś z parametrów jest niepoprawny.
+ * gdy ruch jest nielegalny, któryś z parametrów jest niepoprawny
+ * lub w grze zabrakło pamięci. Gra, w której zabrakło pamięci, nie
+ * przyjmuje już ruchów i można ją tylko usunąć.
  */
 bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
 
@@ -79,11 +251,29 @@ bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
  * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
  *                      @p height z funkcji @ref gamma_new.
  * @return Wartość @p true, jeśli ruch został wykonany, a @p false,
- * gdy gracz wykorzystał już swój złoty ruch, ruch jest nielegalny
- * lub któryś z parametrów jest niepoprawny.
+ * gdy gracz wykorzystał już swój złoty ruch, ruch jest nielegalny,
+ * któryś z parametrów jest niepoprawny lub w grze zabrakło pamięci
+ * (patrz @ref gamma_move).
  */
 bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
 
+/** @brief Wykonuje ciąg ruchów.
+ * Wykonuje kolejno ruchy z tablicy @p moves, zwykłe jak @ref gamma_move,
+ * a złote jak @ref gamma_golden_move, z takim samym wynikiem każdego
+ * ruchu. Sprawdzenie poprawności @p g wykonywane jest raz dla całego
+ * ciągu, a pamięć pomocnicza przeszukiwań planszy jest współdzielona
+ * przez wszystkie ruchy.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] moves   – tablica ruchów,
+ * @param[in] n       – liczba ruchów,
+ * @param[out] results – tablica @p n wyników kolejnych ruchów
+ *                      (@p true, jeśli ruch został wykonany) lub NULL.
+ * @return Liczba wykonanych ruchów lub zero, jeśli któryś z parametrów
+ * jest niepoprawny.
+ */
+size_t gamma_move_batch(gamma_t *g, const move_t *moves, size_t n,
+                        bool *results);
+
 /** @brief Podaje liczbę pól zajętych przez gracza.
  * Podaje liczbę pól zajętych przez gracza @p player.
  * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
@@ -127,4 +317,272 @@ bool gamma_golden_possible(gamma_t *g, uint32_t player);
  */
 char* gamma_board(gamma_t *g);
 
+/** @brief Zapisuje opis prostokątnego fragmentu planszy do bufora.
+ * Opis fragmentu ma taką samą postać jak opis planszy z funkcji
+ * @ref gamma_board, ale obejmuje tylko pola o numerach kolumn od @p x
+ * do @p x + @p width - 1 i numerach wierszy od @p y do @p y + @p height - 1.
+ * Funkcja nie alokuje pamięci, a jej koszt zależy tylko od rozmiaru
+ * fragmentu. Bufor jest zmieniany tylko wtedy, gdy mieści cały opis
+ * wraz z kończącym go znakiem '\0', więc wywołanie z @p buffer równym NULL
+ * i @p length równym 0 podaje potrzebny rozmiar bufora.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] x       – numer pierwszej kolumny fragmentu,
+ * @param[in] y       – numer pierwszego wiersza fragmentu,
+ * @param[in] width   – liczba kolumn fragmentu, liczba dodatnia,
+ * @param[in] height  – liczba wierszy fragmentu, liczba dodatnia,
+ * @param[out] buffer – bufor, w którym zapisujemy opis,
+ * @param[in] length  – rozmiar bufora w bajtach.
+ * @return Długość opisu fragmentu (bez kończącego znaku '\0') lub zero,
+ * jeśli któryś z parametrów jest niepoprawny albo fragment wychodzi
+ * poza planszę.
+ */
+uint64_t gamma_board_region(gamma_t *g, uint32_t x, uint32_t y,
+                            uint32_t width, uint32_t height,
+                            char *buffer, uint64_t length);
+
+/** @brief Zapisuje opis prostokątnego fragmentu planszy do pliku.
+ * Opis ma postać taką jak w funkcji @ref gamma_board_region (bez
+ * kończącego znaku '\0') i jest zapisywany do deskryptora @p fd porcjami
+ * o stałym rozmiarze, bez alokacji pamięci. Opis całej planszy zapisuje
+ * wywołanie dla fragmentu (0, 0, width, height).
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] x       – numer pierwszej kolumny fragmentu,
+ * @param[in] y       – numer pierwszego wiersza fragmentu,
+ * @param[in] width   – liczba kolumn fragmentu, liczba dodatnia,
+ * @param[in] height  – liczba wierszy fragmentu, liczba dodatnia,
+ * @param[in] fd      – deskryptor pliku otwartego do zapisu.
+ * @return Wartość @p true, jeśli zapisano cały opis, a @p false,
+ * gdy któryś z parametrów jest niepoprawny lub zapis się nie powiódł.
+ */
+bool gamma_board_region_write(gamma_t *g, uint32_t x, uint32_t y,
+                              uint32_t width, uint32_t height, int fd);
+
+/** @brief Podaje punkt kontrolny dziennika zmian planszy.
+ * Przy pierwszym wywołaniu włącza zapamiętywanie zmian pól planszy.
+ * Zmiany wykonane po tym wywołaniu można pobrać funkcjami
+ * @ref gamma_changes i @ref gamma_dirty_rows.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Punkt kontrolny odpowiadający bieżącemu stanowi planszy lub zero,
+ * jeśli parametr jest niepoprawny.
+ */
+uint64_t gamma_checkpoint(gamma_t *g);
+
+/** @brief Podaje zmiany pól planszy od punktu kontrolnego.
+ * Zapisuje do tablicy @p changes kolejne zmiany właścicieli pól, od
+ * najstarszej. Koszt zależy tylko od liczby zmian, a nie od rozmiaru
+ * planszy.
+ * @param[in] g          – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] checkpoint – punkt kontrolny z funkcji @ref gamma_checkpoint,
+ *                         niezwolniony funkcją @ref gamma_release_changes,
+ * @param[out] changes   – tablica, w której zapisujemy zmiany,
+ * @param[in] max        – rozmiar tablicy @p changes.
+ * @return Liczba zmian od punktu kontrolnego (zapisywanych jest co najwyżej
+ * @p max najstarszych) lub zero, jeśli któryś z parametrów jest niepoprawny.
+ */
+uint64_t gamma_changes(gamma_t *g, uint64_t checkpoint,
+                       Change *changes, uint64_t max);
+
+/** @brief Podaje wiersze planszy zmienione od punktu kontrolnego.
+ * Każdy wiersz podawany jest raz. Opis zmienionego wiersza @p y można
+ * odświeżyć wywołaniem @ref gamma_board_region dla fragmentu
+ * (0, @p y, width, 1).
+ * @param[in,out] g      – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] checkpoint – punkt kontrolny z funkcji @ref gamma_checkpoint,
+ *                         niezwolniony funkcją @ref gamma_release_changes,
+ * @param[out] rows      – tablica, w której zapisujemy numery wierszy,
+ * @param[in] max        – rozmiar tablicy @p rows.
+ * @return Liczba zmienionych wierszy (zapisywanych jest co najwyżej @p max
+ * pierwszych) lub zero, jeśli któryś z parametrów jest niepoprawny.
+ */
+uint64_t gamma_dirty_rows(gamma_t *g, uint64_t checkpoint,
+                          uint32_t *rows, uint64_t max);
+
+/** @brief Zwalnia zmiany sprzed punktu kontrolnego.
+ * Klient, który odświeżył już planszę do danego punktu kontrolnego,
+ * pozwala w ten sposób zwolnić pamięć zajmowaną przez starsze zmiany.
+ * Nic nie robi, jeśli któryś z parametrów jest niepoprawny.
+ * @param[in,out] g      – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] checkpoint – punkt kontrolny z funkcji @ref gamma_checkpoint.
+ */
+void gamma_release_changes(gamma_t *g, uint64_t checkpoint);
+
+/** @brief Włącza lub wyłącza zapamiętywanie ruchów do cofnięcia.
+ * Po włączeniu każdy wykonany ruch (zwykły lub złoty) zapamiętuje
+ * poprzednie wartości wszystkiego, co zmienił, i można go cofnąć funkcją
+ * @ref gamma_undo. Wyłączenie zapomina wszystkie zapamiętane ruchy.
+ * Domyślnie ruchy nie są zapamiętywane. Nic nie robi, jeśli wskaźnik
+ * @p g ma wartość NULL.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] keep    – @p true, aby zapamiętywać ruchy, @p false, aby
+ *                      przestać je zapamiętywać.
+ */
+void gamma_keep_history(gamma_t *g, bool keep);
+
+/** @brief Cofa ostatni zapamiętany ruch.
+ * Przywraca stan gry sprzed ostatniego zapamiętanego i jeszcze niecofniętego
+ * ruchu. Koszt jest proporcjonalny do liczby zmian wykonanych przez ruch,
+ * czyli dla zwykłego ruchu stały, i nie wymaga alokacji pamięci. Jeśli
+ * włączony jest dziennik zmian planszy, cofnięcie zapisuje w nim
+ * przywrócenie poprzedniego właściciela pola.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli cofnięto ruch, a @p false, gdy nie ma
+ * zapamiętanego ruchu do cofnięcia lub parametr jest niepoprawny.
+ */
+bool gamma_undo(gamma_t *g);
+
+/** @brief Wylicza pola, na których gracz może postawić pionek.
+ * Wywołuje @p callback dla każdego pola, na którym gracz @p player może
+ * w danym stanie gry wykonać zwykły ruch: dla gracza z maksymalną liczbą
+ * obszarów są to wolne pola przyległe do jego pól, a dla pozostałych
+ * wszystkie wolne pola. Pola podawane są w kolejności rosnących numerów
+ * wierszy, a w wierszu rosnących numerów kolumn. Zbiory tych pól
+ * budowane są przy pierwszym wywołaniu, a potem aktualizowane przez
+ * ruchy, więc kolejne wywołania nie przeglądają planszy pole po polu.
+ * Funkcja @p callback nie może zmieniać stanu gry.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
+ *                      @p players z funkcji @ref gamma_new,
+ * @param[in] callback – funkcja wywoływana dla kolejnych pól,
+ * @param[in] data    – dane przekazywane funkcji @p callback.
+ * @return Liczba wyliczonych pól lub zero, jeśli któryś z parametrów
+ * jest niepoprawny.
+ */
+uint64_t gamma_legal_moves(gamma_t *g, uint32_t player,
+                           field_callback_t callback, void *data);
+
+/** @brief Podaje liczbę pól, na których gracz może postawić pionek.
+ * Jest to liczba pól wyliczanych przez @ref gamma_legal_moves, równa
+ * wynikowi @ref gamma_free_fields, i jest podawana w czasie stałym.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
+ *                      @p players z funkcji @ref gamma_new.
+ * @return Liczba pól, na których gracz może postawić pionek lub zero,
+ * jeśli któryś z parametrów jest niepoprawny.
+ */
+uint64_t gamma_legal_count(gamma_t *g, uint32_t player);
+
+/** @brief Wylicza pola, które gracz może zająć złotym ruchem.
+ * Wywołuje @p callback dla każdego pola, na którym gracz @p player może
+ * w danym stanie gry wykonać złoty ruch, w kolejności rosnących numerów
+ * wierszy, a w wierszu rosnących numerów kolumn. Przeglądane są tylko
+ * zajęte pola (gra pamięta ich listę), a jeśli gracz ma już maksymalną
+ * liczbę obszarów - tylko pola przeciwników sąsiadujące z jego polami
+ * (gra pamięta też listy pól poszczególnych graczy), więc czas zależy
+ * od liczby pól gracza, a nie od rozmiaru planszy. Sprawdzenie pola nie
+ * przeszukuje planszy: liczba części, na które rozpadnie się obszar
+ * zabieranego pola, jest wyznaczana raz dla całego obszaru (punkty
+ * artykulacji) i pamiętana, dopóki obszar się nie zmieni.
+ * Funkcja @p callback nie może zmieniać stanu gry.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
+ *                      @p players z funkcji @ref gamma_new,
+ * @param[in] callback – funkcja wywoływana dla kolejnych pól,
+ * @param[in] data    – dane przekazywane funkcji @p callback.
+ * @return Liczba wyliczonych pól lub zero, jeśli któryś z parametrów
+ * jest niepoprawny albo nie udało się zaalokować pamięci - wtedy funkcja
+ * @p callback nie jest wywoływana.
+ */
+uint64_t gamma_golden_candidates(gamma_t *g, uint32_t player,
+                                 field_callback_t callback, void *data);
+
+/** @brief Sprawdza, czy gracz może wykonać jakikolwiek złoty ruch.
+ * W odróżnieniu od @ref gamma_golden_possible sprawdza, czy istnieje
+ * pole, na którym złoty ruch jest dozwolony. Gracz, który nie ma jeszcze
+ * maksymalnej liczby obszarów, może zabrać pole każdemu przeciwnikowi,
+ * bo każdy obszar ma pole, którego zabranie go nie podzieli - wtedy
+ * wystarczy sprawdzić statystyki graczy. W przeciwnym wypadku pola
+ * przeciwników sąsiadujące z polami gracza przeglądane są jak
+ * w @ref gamma_golden_candidates, do pierwszego dozwolonego, więc czas
+ * jest co najwyżej proporcjonalny do liczby pól gracza.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
+ *                      @p players z funkcji @ref gamma_new.
+ * @return Wartość @p true, jeśli gracz może wykonać złoty ruch,
+ * a @p false w przeciwnym przypadku lub gdy nie udało się zaalokować
+ * pamięci.
+ */
+bool gamma_golden_legal(gamma_t *g, uint32_t player);
+
+/** @brief Podaje hasz stanu gry.
+ * Hasz uwzględnia właścicieli wszystkich pól i to, którzy gracze mogą
+ * jeszcze wykonać złoty ruch, i jest aktualizowany w czasie stałym przez
+ * każdy ruch i jego cofnięcie. Takie same stany gier o tych samych
+ * wymiarach i liczbie graczy mają taki sam hasz.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] to_move – numer gracza, na którego ruch czeka gra, jeśli ma
+ *                      być uwzględniony w haszu, lub zero.
+ * @return Hasz stanu gry lub zero, jeśli wskaźnik @p g ma wartość NULL.
+ */
+uint64_t gamma_hash(gamma_t *g, uint32_t to_move);
+
+/** @brief Dołącza do gry tablicę transpozycji.
+ * Jedna tablica może być dołączona do wielu gier, także przetwarzanych
+ * przez różne wątki. Gra nie przejmuje własności tablicy - wywołujący
+ * usuwa ją funkcją @ref del_TranspositionTable po usunięciu lub odłączeniu
+ * wszystkich gier. Nic nie robi, jeśli wskaźnik @p g ma wartość NULL.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] table   – tablica utworzona funkcją
+ *                      @ref new_TranspositionTable lub NULL, aby odłączyć
+ *                      tablicę.
+ */
+void gamma_attach_table(gamma_t *g, TranspositionTable *table);
+
+/** @brief Zapisuje w dołączonej tablicy transpozycji wartość stanu gry.
+ * Nic nie robi, jeśli do gry nie dołączono tablicy.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] to_move – jak w funkcji @ref gamma_hash,
+ * @param[in] value   – wartość stanu.
+ */
+void gamma_table_store(gamma_t *g, uint32_t to_move, uint64_t value);
+
+/** @brief Odczytuje z dołączonej tablicy transpozycji wartość stanu gry.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] to_move – jak w funkcji @ref gamma_hash,
+ * @param[out] value  – odczytana wartość stanu.
+ * @return Wartość @p true, jeśli tablica zawiera wpis dla stanu gry,
+ * a @p false, jeśli go nie zawiera, do gry nie dołączono tablicy
+ * lub któryś z parametrów jest niepoprawny.
+ */
+bool gamma_table_probe(gamma_t *g, uint32_t to_move, uint64_t *value);
+
+/** @brief Rozgrywa partię do końca losowymi ruchami.
+ * Gracze, zaczynając od gracza @p first, wykonują na zmianę losowe
+ * poprawne ruchy, w tym złote. Gracz, który nie może wykonać ruchu,
+ * traci kolejkę. Partia kończy się, gdy żaden gracz nie może wykonać
+ * ruchu. Po rozgrywce stan gry jest przywracany, więc funkcję można
+ * wywoływać wielokrotnie dla tej samej pozycji. Rozgrywka nie alokuje
+ * pamięci przy kolejnych ruchach.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] first   – numer gracza, który wykonuje pierwszy ruch,
+ * @param[in] seed    – ziarno generatora liczb pseudolosowych,
+ * @param[out] scores – tablica o rozmiarze co najmniej liczby graczy,
+ *                      w której na pozycji p - 1 zapisywana jest liczba
+ *                      pól zajętych przez gracza p na końcu partii.
+ * @return Wartość @p true, jeśli partia została rozegrana, a @p false,
+ * gdy nie udało się zaalokować pamięci lub któryś z parametrów jest
+ * niepoprawny.
+ */
+bool gamma_playout(gamma_t *g, uint32_t first, uint64_t seed,
+                   uint64_t *scores);
+
+/** @brief Podaje statystyki pracy silnika dla gry.
+ * Statystyki zbierane są od utworzenia gry lub od ostatniego wywołania
+ * @ref gamma_stats_reset, tylko jeśli silnik skompilowano z opcją
+ * GAMMA_STATS. Liczniki pracy modułów silnika przypisywane są grze
+ * w funkcjach wymienionych w @ref gamma_function.
+ * @param[in] g     – wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] out  – wskaźnik na strukturę, w której zapisywane są
+ *                    statystyki.
+ * @return Wartość @p true, jeśli statystyki zostały zapisane, a @p false,
+ * gdy silnik skompilowano bez statystyk lub któryś z parametrów jest
+ * niepoprawny.
+ */
+bool gamma_stats(gamma_t *g, gamma_stats_t *out);
+
+/** @brief Zeruje statystyki pracy silnika dla gry.
+ * Bez opcji GAMMA_STATS nic nie robi.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ */
+void gamma_stats_reset(gamma_t *g);
+
 #endif /* GAMMA_H */
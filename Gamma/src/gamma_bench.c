@@ -0,0 +1,486 @@
+/** @file
+ * Pomiary wydajności silnika gry gamma
+ *
+ * Program wykonuje powtarzalne (wyznaczone przez ziarno) obciążenia
+ * silnika i dla każdej mierzonej funkcji wypisuje wiersz w formacie JSON:
+ * nazwę obciążenia i funkcji, liczbę wywołań, liczbę wywołań zakończonych
+ * powodzeniem, średni czas wywołania, medianę, 99. percentyl i maksimum
+ * czasu wywołania (w nanosekundach, wraz z narzutem pomiaru czasu) oraz
+ * szczytowe zużycie pamięci. Każde obciążenie wykonywane jest w osobnym
+ * procesie, więc szczytowe zużycie pamięci dotyczy tylko jego.
+ *
+ * Wywołanie:
+ * gamma_bench [ziarno [obciążenie]]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "gamma.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * Czasy wywołań jednej funkcji.
+ */
+struct sample {
+    /*@{*/
+    uint64_t *ns; /**< czasy kolejnych wywołań */
+    uint64_t count; /**< liczba wywołań */
+    uint64_t capacity; /**< liczba wywołań, na które jest miejsce */
+    uint64_t ok; /**< liczba wywołań zakończonych powodzeniem */
+    /*@{*/
+};
+
+/**
+ * Mierzy czas wykonania wyrażenia @p call i zapisuje go w próbce @p s.
+ */
+#define TIMED(s, call) do { \
+        uint64_t start_ = now_ns(); \
+        call; \
+        record(s, now_ns() - start_); \
+    } while (0)
+
+/** @brief Podaje bieżący czas.
+ * @return liczba nanosekund od ustalonej chwili
+ */
+static inline uint64_t now_ns() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t) t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+/** @brief Losuje liczbę generatorem xorshift64*.
+ * @param[in, out] state - niezerowy stan generatora
+ * @param[in] n - liczba dodatnia
+ * @return liczba z przedziału [0, n)
+ */
+static inline uint64_t next_random(uint64_t *state, uint64_t n) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return (x * 0x2545F4914F6CDD1DULL) % n;
+}
+
+/** @brief Tworzy próbkę z miejscem na dane wywołania.
+ * Pamięć alokowana jest z góry, żeby nie zaburzać pomiarów.
+ * @param[in] capacity - spodziewana liczba wywołań
+ * @return Nowa próbka.
+ */
+static struct sample new_sample(uint64_t capacity) {
+    struct sample s = {malloc(capacity * sizeof(uint64_t)), 0, capacity, 0};
+    if (s.ns == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    return s;
+}
+
+/** @brief Zapisuje czas wywołania w próbce.
+ * @param[in, out] s - próbka
+ * @param[in] ns - czas wywołania
+ */
+static inline void record(struct sample *s, uint64_t ns) {
+    if (s->count == s->capacity) {
+        s->capacity *= 2;
+        s->ns = realloc(s->ns, s->capacity * sizeof(uint64_t));
+        if (s->ns == NULL) {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+    s->ns[s->count++] = ns;
+}
+
+/** @brief Porównuje czasy wywołań dla funkcji qsort.
+ * @param[in] a - wskaźnik na pierwszy czas
+ * @param[in] b - wskaźnik na drugi czas
+ * @return liczba ujemna, zero lub dodatnia, jeśli pierwszy czas jest
+ * odpowiednio mniejszy, równy lub większy od drugiego
+ */
+static int compare(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+/** @brief Podaje percentyl posortowanych czasów wywołań.
+ * @param[in] s - próbka z posortowanymi czasami
+ * @param[in] q - numer percentyla, od 1 do 100
+ * @return najmniejszy czas, od którego nie dłużej trwało @p q procent
+ * wywołań
+ */
+static uint64_t percentile(const struct sample *s, uint64_t q) {
+    return s->ns[(s->count * q + 99) / 100 - 1];
+}
+
+/** @brief Wypisuje wyniki pomiarów funkcji i usuwa próbkę.
+ * @param[in] workload - nazwa obciążenia
+ * @param[in] op - nazwa funkcji
+ * @param[in, out] s - próbka
+ */
+static void report(const char *workload, const char *op, struct sample *s) {
+    if (s->count > 0) {
+        uint64_t total = 0;
+        for (uint64_t i = 0; i < s->count; i++) {
+            total += s->ns[i];
+        }
+        qsort(s->ns, s->count, sizeof(uint64_t), compare);
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        printf("{\"workload\":\"%s\",\"op\":\"%s\",\"ops\":%llu,"
+               "\"ok\":%llu,\"ns_per_op\":%.1f,\"p50_ns\":%llu,"
+               "\"p99_ns\":%llu,\"max_ns\":%llu,\"peak_rss_kb\":%ld}\n",
+               workload, op, (unsigned long long) s->count,
+               (unsigned long long) s->ok, (double) total / s->count,
+               (unsigned long long) percentile(s, 50),
+               (unsigned long long) percentile(s, 99),
+               (unsigned long long) s->ns[s->count - 1], usage.ru_maxrss);
+    }
+    free(s->ns);
+}
+
+/** @brief Tworzy grę, mierząc czas wywołania @ref gamma_new_with_layout.
+ * @param[in] workload - nazwa obciążenia
+ * @param[in] width - szerokość planszy
+ * @param[in] height - wysokość planszy
+ * @param[in] players - liczba graczy
+ * @param[in] areas - maksymalna liczba obszarów gracza
+ * @param[in] layout - układ pól planszy
+ * @return wskaźnik na utworzoną grę
+ */
+static gamma_t *timed_new(const char *workload, uint32_t width,
+                          uint32_t height, uint32_t players, uint32_t areas,
+                          gamma_layout_t layout) {
+    struct sample s = new_sample(1);
+    gamma_t *g;
+    TIMED(&s, g = gamma_new_with_layout(width, height, players, areas,
+                                        layout));
+    if (g == NULL) {
+        fprintf(stderr, "%s: gamma_new failed\n", workload);
+        exit(1);
+    }
+    s.ok++;
+    report(workload, "gamma_new", &s);
+    return g;
+}
+
+/** @brief Wykonuje losowe ruchy, mierząc czasy wywołań @ref gamma_move
+ * i następujących po nich wywołań @ref gamma_free_fields.
+ * @param[in] workload - nazwa obciążenia
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] attempts - liczba prób ruchu
+ * @param[in, out] random - stan generatora liczb pseudolosowych
+ */
+static void random_moves(const char *workload, gamma_t *g, uint64_t attempts,
+                         uint64_t *random) {
+    struct sample moves = new_sample(attempts);
+    struct sample free_fields = new_sample(attempts);
+    for (uint64_t i = 0; i < attempts; i++) {
+        uint32_t p = 1 + next_random(random, g->number_of_players);
+        uint32_t x = next_random(random, g->width);
+        uint32_t y = next_random(random, g->height);
+        bool ok;
+        TIMED(&moves, ok = gamma_move(g, p, x, y));
+        moves.ok += ok;
+        uint64_t result;
+        TIMED(&free_fields, result = gamma_free_fields(g, p));
+        free_fields.ok += result > 0;
+    }
+    report(workload, "gamma_move", &moves);
+    report(workload, "gamma_free_fields", &free_fields);
+}
+
+/** @brief Losuje zajęte pole planszy.
+ * Pola losowane są do skutku, więc na planszy musi być zajęte pole.
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[out] x - numer kolumny pola
+ * @param[out] y - numer wiersza pola
+ * @param[in, out] random - stan generatora liczb pseudolosowych
+ * @return numer gracza zajmującego pole
+ */
+static uint32_t random_piece(gamma_t *g, uint32_t *x, uint32_t *y,
+                             uint64_t *random) {
+    char field[32];
+    uint32_t owner = 0;
+    while (owner == 0) {
+        *x = next_random(random, g->width);
+        *y = next_random(random, g->height);
+        gamma_board_region(g, *x, *y, 1, 1, field, sizeof(field));
+        owner = strtoul(field, NULL, 10);
+    }
+    return owner;
+}
+
+/** @brief Wykonuje losowe złote ruchy, mierząc osobno czasy udanych
+ * i odrzuconych wywołań @ref gamma_golden_move.
+ * Każda próba zabiera losowemu przeciwnikowi losowe zajęte pole, a udany
+ * ruch jest cofany, żeby gracze nie tracili złotego ruchu i każda próba
+ * sprawdzała podział obszarów. Gra musi mieć co najmniej dwóch graczy.
+ * @param[in] workload - nazwa obciążenia
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] attempts - liczba prób złotego ruchu
+ * @param[in, out] random - stan generatora liczb pseudolosowych
+ */
+static void random_golden_moves(const char *workload, gamma_t *g,
+                                uint64_t attempts, uint64_t *random) {
+    struct sample accepted = new_sample(attempts);
+    struct sample rejected = new_sample(attempts);
+    gamma_keep_history(g, true);
+    for (uint64_t i = 0; i < attempts; i++) {
+        uint32_t x, y;
+        uint32_t owner = random_piece(g, &x, &y, random);
+        uint32_t p = 1 + next_random(random, g->number_of_players - 1);
+        if (p >= owner) { p++; }
+        uint64_t start = now_ns();
+        bool ok = gamma_golden_move(g, p, x, y);
+        record(ok ? &accepted : &rejected, now_ns() - start);
+        if (ok) {
+            accepted.ok++;
+            gamma_undo(g);
+        }
+    }
+    gamma_keep_history(g, false);
+    report(workload, "gamma_golden_move_accepted", &accepted);
+    report(workload, "gamma_golden_move_rejected", &rejected);
+}
+
+/** @brief Mierzy czasy wywołań @ref gamma_board.
+ * @param[in] workload - nazwa obciążenia
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] repeats - liczba wywołań
+ */
+static void render(const char *workload, gamma_t *g, uint64_t repeats) {
+    struct sample s = new_sample(repeats);
+    for (uint64_t i = 0; i < repeats; i++) {
+        char *board;
+        TIMED(&s, board = gamma_board(g));
+        s.ok += board != NULL;
+        free(board);
+    }
+    report(workload, "gamma_board", &s);
+}
+
+/** @brief Wypełnia planszę, mierząc czasy wywołań @ref gamma_move
+ * i następujących po nich wywołań @ref gamma_free_fields.
+ * Pola, przeglądane wiersz po wierszu, dzielone są na tyle kolejnych
+ * odcinków, ilu jest graczy, i zwykle oddawane właścicielowi odcinka,
+ * a czasem losowemu graczowi spośród właścicieli odcinków już
+ * rozpoczętych, któremu tworzą nowe obszary. Ruchy przekraczające limit
+ * obszarów nie są wykonywane.
+ * @param[in] workload - nazwa obciążenia lub NULL, jeśli wyniki pomiarów
+ * nie mają być wypisane
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in, out] random - stan generatora liczb pseudolosowych
+ */
+static void fill(const char *workload, gamma_t *g, uint64_t *random) {
+    uint64_t fields = (uint64_t) g->width * g->height;
+    struct sample moves = new_sample(fields);
+    struct sample free_fields = new_sample(fields);
+    for (uint32_t y = 0; y < g->height; y++) {
+        for (uint32_t x = 0; x < g->width; x++) {
+            uint64_t i = (uint64_t) y * g->width + x;
+            uint32_t p = 1 + i * g->number_of_players / fields;
+            if (next_random(random, 8) == 0) {
+                p = 1 + next_random(random, p);
+            }
+            bool ok;
+            TIMED(&moves, ok = gamma_move(g, p, x, y));
+            moves.ok += ok;
+            uint64_t result;
+            TIMED(&free_fields, result = gamma_free_fields(g, p));
+            free_fields.ok += result > 0;
+        }
+    }
+    if (workload == NULL) {
+        moves.count = free_fields.count = 0;
+    }
+    report(workload, "gamma_move", &moves);
+    report(workload, "gamma_free_fields", &free_fields);
+}
+
+/** @brief Zapełnia planszę pasami pól graczy do limitu ich obszarów.
+ * @param[in] seed - ziarno obciążenia
+ */
+static void dense_fill(uint64_t seed) {
+    const char *name = "dense_fill";
+    gamma_t *g = timed_new(name, 512, 512, 8, 16, GAMMA_LAYOUT_ROWS);
+    fill(name, g, &seed);
+    render(name, g, 10);
+    gamma_delete(g);
+}
+
+/** @brief Wykonuje wiele złotych ruchów w grze z wieloma graczami, których
+ * obszary dzielą się po zabraniu pola.
+ * @param[in] seed - ziarno obciążenia
+ */
+static void golden_storm(uint64_t seed) {
+    const char *name = "golden_storm";
+    gamma_t *g = timed_new(name, 512, 512, 4096, 32, GAMMA_LAYOUT_ROWS);
+    fill(NULL, g, &seed);
+    random_golden_moves(name, g, 200000, &seed);
+    gamma_delete(g);
+}
+
+/** @brief Wykonuje nieliczne ruchy na wielkiej planszy.
+ * @param[in] seed - ziarno obciążenia
+ */
+static void huge_sparse(uint64_t seed) {
+    const char *name = "huge_sparse";
+    gamma_t *g = timed_new(name, 4000, 4000, 4, 100000, GAMMA_LAYOUT_ROWS);
+    random_moves(name, g, 200000, &seed);
+    random_golden_moves(name, g, 1000, &seed);
+    render(name, g, 1);
+    gamma_delete(g);
+}
+
+/** @brief Wykonuje ruchy w grze z bardzo wieloma graczami.
+ * @param[in] seed - ziarno obciążenia
+ */
+static void many_players(uint64_t seed) {
+    const char *name = "many_players";
+    gamma_t *g = timed_new(name, 1024, 1024, 100000, 4, GAMMA_LAYOUT_ROWS);
+    random_moves(name, g, 1000000, &seed);
+    random_golden_moves(name, g, 100000, &seed);
+    render(name, g, 3);
+    gamma_delete(g);
+}
+
+/** @brief Opisuje zapełnione plansze, dużą z numerami graczy różnej
+ * długości i małą.
+ * @param[in] seed - ziarno obciążenia
+ */
+static void board_render(uint64_t seed) {
+    gamma_t *g = timed_new("render_large", 1000, 1000, 300, 1000000,
+                           GAMMA_LAYOUT_ROWS);
+    fill(NULL, g, &seed);
+    render("render_large", g, 20);
+    gamma_delete(g);
+
+    g = timed_new("render_small", 10, 10, 4, 100, GAMMA_LAYOUT_ROWS);
+    fill(NULL, g, &seed);
+    render("render_small", g, 100000);
+    gamma_delete(g);
+}
+
+/**
+ * Szerokość pasów pól gracza 1 w obciążeniu @ref flood.
+ */
+#define BAND 7
+
+/** @brief Mierzy złote ruchy dzielące wielki obszar na dwie duże części.
+ * Szeroka plansza zapełniona jest wężem: pionowymi pasami pól gracza 1
+ * o szerokości @ref BAND kolumn, przedzielonymi kolumnami pól gracza 2
+ * z przejściem na przemian przy dolnym i górnym brzegu. Złoty ruch
+ * gracza 2 na losowe przejście przecina węża, więc każdy wymaga
+ * przeszukania dużej części planszy, a potem jest cofany. Przeszukiwanie
+ * wąskiego pasa przechodzi co kilka pól do następnego wiersza, czyli
+ * w układzie wierszowym do innej linii pamięci podręcznej.
+ * @param[in] workload - nazwa obciążenia
+ * @param[in] layout - układ pól planszy
+ * @param[in, out] random - stan generatora liczb pseudolosowych
+ */
+static void cut_snake(const char *workload, gamma_layout_t layout,
+                      uint64_t *random) {
+    gamma_t *g = timed_new(workload, 4096, 512, 2, 4096, layout);
+    uint32_t walls = g->width / (BAND + 1);
+    for (uint32_t y = 0; y < g->height; y++) {
+        for (uint32_t x = 0; x < g->width; x++) {
+            uint32_t gap = x / (BAND + 1) % 2 == 0 ? g->height - 1 : 0;
+            bool wall = x % (BAND + 1) == BAND && y != gap;
+            gamma_move(g, wall ? 2 : 1, x, y);
+        }
+    }
+    gamma_keep_history(g, true);
+    struct sample s = new_sample(50);
+    for (int i = 0; i < 50; i++) {
+        // Przejście w ostatniej kolumnie planszy niczego nie łączy.
+        uint32_t k = next_random(random, walls - 1);
+        uint32_t x = k * (BAND + 1) + BAND;
+        uint32_t y = k % 2 == 0 ? g->height - 1 : 0;
+        bool ok;
+        TIMED(&s, ok = gamma_golden_move(g, 2, x, y));
+        s.ok += ok;
+        if (ok) { gamma_undo(g); }
+    }
+    report(workload, "gamma_golden_move", &s);
+    gamma_delete(g);
+}
+
+/** @brief Porównuje przeszukiwania wielkich obszarów w obu układach
+ * planszy, przy takich samych ruchach.
+ * @param[in] seed - ziarno obciążenia
+ */
+static void flood(uint64_t seed) {
+    uint64_t random = seed;
+    cut_snake("flood_rows", GAMMA_LAYOUT_ROWS, &random);
+    random = seed;
+    cut_snake("flood_tiles", GAMMA_LAYOUT_TILES, &random);
+}
+
+/**
+ * Obciążenie silnika.
+ */
+struct workload {
+    /*@{*/
+    const char *name; /**< nazwa obciążenia */
+    void (*run)(uint64_t seed); /**< funkcja wykonująca obciążenie */
+    /*@{*/
+};
+
+/**
+ * Wszystkie obciążenia, w kolejności wykonywania.
+ */
+static const struct workload workloads[] = {
+    {"dense_fill", dense_fill},
+    {"flood", flood},
+    {"golden_storm", golden_storm},
+    {"huge_sparse", huge_sparse},
+    {"many_players", many_players},
+    {"render", board_render}
+};
+
+/** @brief Wykonuje obciążenia.
+ * @param[in] argc - liczba parametrów
+ * @param[in] argv - parametry
+ * @return Zero, jeśli wszystkie obciążenia zostały wykonane, a w przeciwnym
+ * przypadku kod błędu.
+ */
+int main(int argc, char *argv[]) {
+    uint64_t seed = argc > 1 ? strtoull(argv[1], NULL, 10) : 1;
+    const char *only = argc > 2 ? argv[2] : NULL;
+    int result = 0;
+    bool found = false;
+    for (size_t i = 0; i < sizeof(workloads) / sizeof(workloads[0]); i++) {
+        if (only != NULL && strcmp(only, workloads[i].name) != 0) {
+            continue;
+        }
+        found = true;
+        // Stan generatora nie może być zerem.
+        uint64_t state = mix64(seed ^ mix64(i)) | 1;
+        fflush(stdout);
+        pid_t child = fork();
+        if (child == 0) {
+            workloads[i].run(state);
+            fflush(stdout);
+            _exit(0);
+        }
+        int status;
+        if (child < 0 || waitpid(child, &status, 0) != child ||
+            !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "%s: failed\n", workloads[i].name);
+            result = 1;
+        }
+    }
+    if (!found) {
+        fprintf(stderr, "usage: %s [seed [workload]]\n", argv[0]);
+        return 1;
+    }
+    return result;
+}
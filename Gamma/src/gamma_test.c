@@ -11,11 +11,14 @@
 #undef NDEBUG
 #endif
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "gamma.h"
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 /**
  * Tak ma wyglądać plansza po wykonaniu wszystkich testów.
@@ -32,6 +35,76 @@ static const char board[] =
   "1221......\n"
   "1.........\n";
 
+/** @brief Zlicza pola wyliczone przez silnik.
+ * @param[in] x       – numer kolumny pola,
+ * @param[in] y       – numer wiersza pola,
+ * @param[in,out] data – wskaźnik na licznik pól.
+ */
+static void count_field(uint32_t x, uint32_t y, void *data) {
+  (void) x;
+  (void) y;
+  ++*(uint64_t *) data;
+}
+
+/** @brief Alokuje pamięć, zliczając zaalokowane bloki.
+ * @param[in,out] data – wskaźnik na licznik bloków,
+ * @param[in] size     – rozmiar pamięci.
+ * @return Wskaźnik na zaalokowaną pamięć lub NULL.
+ */
+static void *count_allocate(void *data, size_t size) {
+  void *p = malloc(size);
+  if (p != NULL) ++*(int64_t *) data;
+  return p;
+}
+
+/** @brief Zmienia rozmiar pamięci.
+ * @param[in] data – wskaźnik na licznik bloków,
+ * @param[in] p    – wskaźnik na pamięć lub NULL,
+ * @param[in] size – nowy rozmiar pamięci.
+ * @return Wskaźnik na pamięć o nowym rozmiarze lub NULL.
+ */
+static void *count_reallocate(void *data, void *p, size_t size) {
+  if (p == NULL) return count_allocate(data, size);
+  return realloc(p, size);
+}
+
+/** @brief Zwalnia pamięć, zliczając zwolnione bloki.
+ * @param[in,out] data – wskaźnik na licznik bloków,
+ * @param[in] p        – wskaźnik na pamięć.
+ */
+static void count_release(void *data, void *p) {
+  free(p);
+  --*(int64_t *) data;
+}
+
+/** @brief Alokuje pamięć, chyba że alokacje mają się nie udawać.
+ * @param[in] data – wskaźnik na znacznik nieudanych alokacji,
+ * @param[in] size – rozmiar pamięci.
+ * @return Wskaźnik na zaalokowaną pamięć lub NULL.
+ */
+static void *fail_allocate(void *data, size_t size) {
+  return *(bool *) data ? NULL : malloc(size);
+}
+
+/** @brief Zmienia rozmiar pamięci, chyba że alokacje mają się nie udawać.
+ * @param[in] data – wskaźnik na znacznik nieudanych alokacji,
+ * @param[in] p    – wskaźnik na pamięć lub NULL,
+ * @param[in] size – nowy rozmiar pamięci.
+ * @return Wskaźnik na pamięć o nowym rozmiarze lub NULL.
+ */
+static void *fail_reallocate(void *data, void *p, size_t size) {
+  return *(bool *) data ? NULL : realloc(p, size);
+}
+
+/** @brief Zwalnia pamięć.
+ * @param[in] data – wskaźnik na znacznik nieudanych alokacji,
+ * @param[in] p    – wskaźnik na pamięć.
+ */
+static void fail_release(void *data, void *p) {
+  (void) data;
+  free(p);
+}
+
 /** @brief Testuje silnik gry gamma.
  * Przeprowadza przykładowe testy silnika gry gamma.
  * @return Zero, gdy wszystkie testy przebiegły poprawnie,
@@ -93,6 +166,236 @@ int main() {
   printf(p);
   free(p);
 
+  char region[16];
+  assert(gamma_board_region(g, 0, 0, 4, 2, region, sizeof(region)) == 10);
+  assert(strcmp(region, "1221\n1...\n") == 0);
+  assert(gamma_board_region(g, 8, 0, 4, 2, region, sizeof(region)) == 0);
+
+  uint64_t checkpoint = gamma_checkpoint(g);
+  assert(gamma_move(g, 2, 7, 6));
+  Change change;
+  assert(gamma_changes(g, checkpoint, &change, 1) == 1);
+  assert(change.x == 7 && change.y == 6);
+  assert(change.previous == 0 && change.current == 2);
+  uint32_t row;
+  assert(gamma_dirty_rows(g, checkpoint, &row, 1) == 1 && row == 6);
+
+  gamma_keep_history(g, true);
+  uint64_t hash = gamma_hash(g, 0);
+  assert(gamma_move(g, 2, 8, 6));
+  assert(gamma_busy_fields(g, 2) == 6);
+  assert(gamma_hash(g, 0) != hash);
+  assert(gamma_undo(g));
+  assert(gamma_busy_fields(g, 2) == 5);
+  assert(gamma_hash(g, 0) == hash);
+  assert(!gamma_undo(g));
+
+  uint64_t sizes[][2] = {{1, 0}, {1000, 511}, {1024, 1023}};
+  for (int i = 0; i < 3; i++) {
+    TranspositionTable *t = new_TranspositionTable(sizes[i][0]);
+    assert(t != NULL && t->mask == sizes[i][1]);
+    del_TranspositionTable(t);
+  }
+  assert(new_TranspositionTable(0) == NULL);
+  uint64_t value = 0;
+  gamma_table_store(g, 1, 77);
+  assert(!gamma_table_probe(g, 1, &value));
+  TranspositionTable *table = new_TranspositionTable(1000);
+  assert(table != NULL);
+  gamma_attach_table(g, table);
+  gamma_table_store(g, 1, 77);
+  assert(gamma_table_probe(g, 1, &value) && value == 77);
+  assert(!gamma_table_probe(g, 2, &value));
+  assert(gamma_move(g, 2, 8, 6));
+  assert(!gamma_table_probe(g, 1, &value));
+  assert(gamma_undo(g));
+  assert(gamma_table_probe(g, 1, &value) && value == 77);
+  gamma_attach_table(g, NULL);
+  assert(!gamma_table_probe(g, 1, &value));
+  del_TranspositionTable(table);
+
+  move_t moves[] = {{2, 8, 6, false}, {2, 8, 6, false}};
+  bool results[2];
+  assert(gamma_move_batch(g, moves, 2, results) == 1);
+  assert(results[0] && !results[1]);
+
+  uint64_t legal = 0;
+  uint64_t listed = gamma_legal_moves(g, 1, count_field, &legal);
+  assert(listed == legal);
+  assert(legal == gamma_legal_count(g, 1));
+  assert(legal == gamma_free_fields(g, 1));
+  assert(!gamma_golden_legal(g, 2));
+  assert(gamma_golden_candidates(g, 2, count_field, &legal) == 0);
+
+  uint64_t scores[2];
+  hash = gamma_hash(g, 0);
+  assert(gamma_playout(g, 1, 42, scores));
+  assert(scores[0] + scores[1] <= 100);
+  assert(gamma_hash(g, 0) == hash);
+  assert(gamma_busy_fields(g, 2) == 6);
+  assert(!gamma_playout(g, 3, 42, scores));
+
+  gamma_stats_t stats;
+#ifdef GAMMA_STATS
+  assert(gamma_stats(g, &stats));
+  assert(stats.calls[GAMMA_STAT_NEW] == 1);
+  assert(stats.moves_accepted > 0 && stats.moves_rejected > 0);
+  assert(stats.golden_accepted == 2 && stats.golden_rejected == 1);
+  assert(stats.calls[GAMMA_STAT_PLAYOUT] == 2);
+  gamma_stats_reset(g);
+  assert(gamma_stats(g, &stats) && stats.calls[GAMMA_STAT_MOVE] == 0);
+#else
+  assert(!gamma_stats(g, &stats));
+#endif
+
+  gamma_delete(g);
+
+  for (int layout = GAMMA_LAYOUT_ROWS; layout <= GAMMA_LAYOUT_TILES; layout++) {
+    g = gamma_new_with_layout(3, 1, 123, 1, (gamma_layout_t) layout);
+    assert(gamma_move(g, 12, 0, 0) && gamma_move(g, 123, 1, 0));
+    p = gamma_board(g);
+    assert(p && strcmp(p, " 12  123 .\n") == 0);
+    free(p);
+    gamma_delete(g);
+  }
+
+  g = gamma_new(3000, 4, 1000, 10000);
+  assert(g != NULL);
+  for (uint32_t i = 0; i < 3000 * 4; i += 1 + i % 3) {
+    assert(gamma_move(g, 1 + i * 37 % 1000, i % 3000, i / 3000));
+  }
+  uint32_t regions[][4] = {{0, 0, 3000, 4}, {5, 1, 2990, 2}, {1234, 3, 1, 1}};
+  for (int i = 0; i < 3; i++) {
+    uint32_t *r = regions[i];
+    uint64_t length = gamma_board_region(g, r[0], r[1], r[2], r[3], NULL, 0);
+    char *expected = malloc(length + 1);
+    char *written = malloc(length + 1);
+    assert(expected != NULL && written != NULL);
+    assert(gamma_board_region(g, r[0], r[1], r[2], r[3], expected,
+                              length + 1) == length);
+    FILE *file = tmpfile();
+    assert(file != NULL);
+    assert(gamma_board_region_write(g, r[0], r[1], r[2], r[3], fileno(file)));
+    rewind(file);
+    assert(fread(written, 1, length + 1, file) == length);
+    assert(memcmp(written, expected, length) == 0);
+    fclose(file);
+    free(expected);
+    free(written);
+  }
+  assert(!gamma_board_region_write(g, 0, 0, 3000, 4, -1));
+  assert(!gamma_board_region_write(g, 0, 0, 3001, 1, STDOUT_FILENO));
+  assert(!gamma_board_region_write(g, 3000, 0, 1, 1, STDOUT_FILENO));
+  assert(!gamma_board_region_write(g, 0, 2, 1, 3, STDOUT_FILENO));
+  assert(!gamma_board_region_write(g, 0, 0, 0, 1, STDOUT_FILENO));
+  gamma_delete(g);
+
+  int64_t blocks = 0;
+  gamma_allocator_t allocator = {count_allocate, count_reallocate,
+                                 count_release, &blocks};
+  g = gamma_new_with_allocator(10, 10, 2, 3, &allocator);
+  assert(g != NULL && blocks > 0);
+  gamma_keep_history(g, true);
+  assert(gamma_playout(g, 1, 7, scores));
+  assert(gamma_legal_moves(g, 1, count_field, &legal) == 100);
+  gamma_delete(g);
+  assert(blocks == 0);
+
+  bool failing = false;
+  gamma_allocator_t failing_allocator = {fail_allocate, fail_reallocate,
+                                         fail_release, &failing};
+  g = gamma_new_with_allocator(100, 100, 2, 2, &failing_allocator);
+  assert(g != NULL);
+  assert(gamma_move(g, 1, 0, 0) && gamma_move(g, 1, 1, 0));
+  assert(gamma_move(g, 1, 2, 0) && gamma_move(g, 1, 5, 0));
+  assert(gamma_move(g, 2, 99, 99));
+  failing = true;
+  legal = 0;
+  assert(gamma_golden_candidates(g, 2, count_field, &legal) == 0);
+  assert(legal == 0 && !gamma_golden_legal(g, 2));
+  assert(!gamma_golden_move(g, 2, 1, 0));
+  failing = false;
+  gamma_delete(g);
+
+  g = gamma_new_with_allocator(100, 100, 2, 100, &failing_allocator);
+  assert(g != NULL);
+  for (uint32_t i = 0; i < 64; i++) {
+    assert(gamma_move(g, 1, 2 * (i % 50), 2 * (i / 50)));
+  }
+  uint64_t node = node_of(&g->regions, field_index(&g->board, 99, 1));
+  failing = true;
+  assert(!gamma_move(g, 1, 1, 99));
+  assert(g->regions.failed);
+  assert(node_of(&g->regions, field_index(&g->board, 99, 1)) == node);
+  failing = false;
+  gamma_delete(g);
+
+  gamma_t *tiled = gamma_new_with_layout(21, 13, 3, 4, GAMMA_LAYOUT_TILES);
+  g = gamma_new(21, 13, 3, 4);
+  assert(g != NULL && tiled != NULL);
+  for (uint32_t i = 0; i < 300; i++) {
+    uint32_t player = 1 + i % 3, x = i * 7 % 21, y = i * 5 % 13;
+    assert(gamma_move(g, player, x, y) == gamma_move(tiled, player, x, y));
+  }
+  assert(gamma_golden_move(g, 1, 7, 5) == gamma_golden_move(tiled, 1, 7, 5));
+  char *rows_board = gamma_board(g), *tiled_board = gamma_board(tiled);
+  assert(strcmp(rows_board, tiled_board) == 0);
+  free(rows_board);
+  free(tiled_board);
+  assert(gamma_legal_count(g, 2) == gamma_legal_count(tiled, 2));
+  for (uint32_t player = 1; player <= 3; player++) {
+    assert(gamma_free_fields(g, player) == gamma_free_fields(tiled, player));
+    assert(gamma_golden_candidates(g, player, count_field, &legal) ==
+           gamma_golden_candidates(tiled, player, count_field, &legal));
+  }
+  FILE *snapshot = tmpfile();
+  assert(snapshot != NULL && gamma_save(g, fileno(snapshot)));
+  gamma_t *loaded = gamma_load(fileno(snapshot));
+  fclose(snapshot);
+  assert(loaded != NULL);
+  rows_board = gamma_board(g);
+  char *loaded_board = gamma_board(loaded);
+  assert(strcmp(rows_board, loaded_board) == 0);
+  free(rows_board);
+  free(loaded_board);
+  assert(gamma_hash(loaded, 1) == gamma_hash(g, 1));
+  assert(gamma_golden_move(loaded, 2, 7, 5) == gamma_golden_move(g, 2, 7, 5));
+  assert(gamma_busy_fields(loaded, 2) == gamma_busy_fields(g, 2));
+  assert(gamma_free_fields(loaded, 3) == gamma_free_fields(g, 3));
+  gamma_t *copy = gamma_clone(loaded);
+  assert(copy != NULL);
+  gamma_delete(loaded);
+  assert(gamma_hash(copy, 1) == gamma_hash(g, 1));
+  assert(gamma_busy_fields(copy, 2) == gamma_busy_fields(g, 2));
+  assert(gamma_move(copy, 3, 0, 0) == gamma_move(g, 3, 0, 0));
+  assert(gamma_hash(copy, 1) == gamma_hash(g, 1));
+  gamma_delete(copy);
+  gamma_delete(tiled);
+  gamma_delete(g);
+
+  g = gamma_new(20000, 20000, 2, 2);
+  assert(g != NULL);
+  assert(gamma_move(g, 1, 0, 0));
+  assert(gamma_move(g, 1, 1, 0));
+  assert(gamma_move(g, 2, 19999, 19999));
+  assert(!gamma_move(g, 1, 20000, 0));
+  assert(gamma_free_fields(g, 1) == 400000000 - 3);
+  assert(gamma_golden_move(g, 2, 1, 0));
+  assert(gamma_busy_fields(g, 1) == 1 && gamma_busy_fields(g, 2) == 2);
+  assert(gamma_golden_legal(g, 1) && !gamma_golden_legal(g, 2));
+  legal = 0;
+  assert(gamma_golden_candidates(g, 1, count_field, &legal) == 2);
+  assert(legal == 2);
+  copy = gamma_clone(g);
+  assert(copy != NULL && gamma_hash(copy, 1) == gamma_hash(g, 1));
+  assert(gamma_golden_move(copy, 1, 19999, 19999));
+  assert(gamma_move(copy, 2, 0, 1));
+  assert(gamma_busy_fields(g, 1) == 1 && gamma_busy_fields(g, 2) == 2);
+  assert(gamma_busy_fields(copy, 1) == 2 && gamma_busy_fields(copy, 2) == 2);
+  assert(gamma_move(g, 1, 0, 1));
+  assert(!gamma_golden_possible(copy, 1) && gamma_golden_possible(g, 1));
   gamma_delete(g);
+  assert(gamma_move(copy, 2, 2, 0) && gamma_busy_fields(copy, 2) == 3);
+  gamma_delete(copy);
   return 0;
 }
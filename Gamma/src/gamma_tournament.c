@@ -0,0 +1,424 @@
+/** @file
+ * Turniej gry gamma rozgrywany przez wiele wątków
+ *
+ * Gracze wykonują losowe poprawne ruchy, w tym złote. Partie dzielone są
+ * po równo między wątki, a wątek, który skończył swoje partie, zabiera
+ * połowę partii czekających u innego wątku (podkradanie pracy). Każda
+ * partia ma własne ziarno generatora liczb pseudolosowych wyznaczone
+ * z jej numeru, więc wyniki turnieju nie zależą od liczby wątków.
+ *
+ * Wywołanie:
+ * gamma_tournament [partie [szerokość [wysokość [gracze [obszary
+ * [wątki [ziarno]]]]]]]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "gamma.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * Liczba losowań pola, po których gracz przestaje szukać ruchu na ślepo
+ * i wybiera go spośród wszystkich dozwolonych pól.
+ */
+#define TRIES 16
+
+/**
+ * Odwrotność prawdopodobieństwa, z jakim gracz próbuje złotego ruchu,
+ * choć może wykonać zwykły.
+ */
+#define GOLDEN_CHANCE 32
+
+/**
+ * Parametry turnieju.
+ */
+struct settings {
+    /*@{*/
+    uint64_t games; /**< liczba partii */
+    uint32_t width; /**< szerokość planszy */
+    uint32_t height; /**< wysokość planszy */
+    uint32_t players; /**< liczba graczy */
+    uint32_t areas; /**< maksymalna liczba obszarów gracza */
+    uint32_t threads; /**< liczba wątków */
+    uint64_t seed; /**< ziarno turnieju */
+    /*@{*/
+};
+
+/**
+ * Wyniki partii rozegranych przez jeden wątek.
+ */
+struct results {
+    /*@{*/
+    uint64_t *wins; /**< liczby wygranych kolejnych graczy */
+    uint64_t draws; /**< liczba remisów */
+    uint64_t failed; /**< liczba partii przerwanych z braku pamięci */
+    uint64_t moves; /**< liczba wykonanych ruchów */
+    /*@{*/
+};
+
+/**
+ * Kolejka partii czekających na rozegranie przez wątek - przedział
+ * numerów partii [next, end).
+ */
+struct queue {
+    /*@{*/
+    pthread_mutex_t lock; /**< blokada kolejki */
+    uint64_t next; /**< numer następnej partii */
+    uint64_t end; /**< numer pierwszej partii za kolejką */
+    /*@{*/
+};
+
+/**
+ * Stan turnieju współdzielony przez wątki.
+ */
+struct tournament {
+    /*@{*/
+    struct settings settings; /**< parametry turnieju */
+    struct queue *queues; /**< kolejki kolejnych wątków */
+    /*@{*/
+};
+
+/**
+ * Wątek turnieju.
+ */
+struct worker {
+    /*@{*/
+    struct tournament *tournament; /**< turniej */
+    uint32_t id; /**< numer wątku */
+    pthread_t thread; /**< wątek systemowy */
+    struct results results; /**< wyniki partii rozegranych przez wątek */
+    /*@{*/
+};
+
+/**
+ * Losowe pole wybierane spośród pól wyliczanych przez silnik.
+ */
+struct pick {
+    /*@{*/
+    uint64_t *random; /**< stan generatora liczb pseudolosowych */
+    uint64_t seen; /**< liczba dotychczas wyliczonych pól */
+    uint32_t x; /**< numer kolumny wybranego pola */
+    uint32_t y; /**< numer wiersza wybranego pola */
+    /*@{*/
+};
+
+/** @brief Losuje liczbę generatorem xorshift64*.
+ * @param[in, out] state - niezerowy stan generatora
+ * @param[in] n - liczba dodatnia
+ * @return liczba z przedziału [0, n)
+ */
+static inline uint64_t next_random(uint64_t *state, uint64_t n) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return (x * 0x2545F4914F6CDD1DULL) % n;
+}
+
+/** @brief Wybiera pole z prawdopodobieństwem odwrotnym do liczby
+ * dotychczas wyliczonych pól.
+ * @param[in] x - numer kolumny pola
+ * @param[in] y - numer wiersza pola
+ * @param[in, out] data - wskaźnik na strukturę @ref pick
+ */
+static void pick_field(uint32_t x, uint32_t y, void *data) {
+    struct pick *pick = data;
+    if (next_random(pick->random, ++pick->seen) == 0) {
+        pick->x = x;
+        pick->y = y;
+    }
+}
+
+/**
+ * Wynik tury gracza.
+ */
+enum turn {
+    MOVED, /**< gracz wykonał ruch */
+    PASSED, /**< gracz nie mógł wykonać ruchu */
+    FAILED /**< w grze zabrakło pamięci */
+};
+
+/** @brief Wykonuje losowy złoty ruch gracza.
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] player - numer gracza
+ * @param[in] forced - czy gracz nie może wykonać zwykłego ruchu
+ * @param[in, out] random - stan generatora liczb pseudolosowych
+ * @return wynik tury, @ref PASSED, jeśli złoty ruch nie został wykonany
+ */
+static enum turn golden_turn(gamma_t *g, uint32_t player, bool forced,
+                             uint64_t *random) {
+    for (int i = 0; i < TRIES; i++) {
+        if (gamma_golden_move(g, player, next_random(random, g->width),
+                              next_random(random, g->height))) {
+            return MOVED;
+        }
+    }
+    if (!forced) { return PASSED; }
+    struct pick pick = {random, 0, 0, 0};
+    gamma_golden_candidates(g, player, pick_field, &pick);
+    if (pick.seen == 0) { return PASSED; }
+    return gamma_golden_move(g, player, pick.x, pick.y) ? MOVED : FAILED;
+}
+
+/** @brief Wykonuje turę gracza.
+ * Gracz losuje pola, a jeśli żadne nie pozwala na ruch, wybiera losowo
+ * jedno z dozwolonych pól. Złoty ruch wykonuje czasem zamiast zwykłego
+ * i zawsze, gdy nie może wykonać zwykłego.
+ * @param[in,out] g - wskaźnik na strukturę przechowującą stan gry
+ * @param[in] player - numer gracza
+ * @param[in, out] random - stan generatora liczb pseudolosowych
+ * @return wynik tury
+ */
+static enum turn play_turn(gamma_t *g, uint32_t player, uint64_t *random) {
+    bool stuck = gamma_free_fields(g, player) == 0;
+    if (gamma_golden_possible(g, player) &&
+        (stuck || next_random(random, GOLDEN_CHANCE) == 0)) {
+        enum turn result = golden_turn(g, player, stuck, random);
+        if (result != PASSED || stuck) { return result; }
+    }
+    if (stuck) { return PASSED; }
+    for (int i = 0; i < TRIES; i++) {
+        if (gamma_move(g, player, next_random(random, g->width),
+                       next_random(random, g->height))) {
+            return MOVED;
+        }
+    }
+    struct pick pick = {random, 0, 0, 0};
+    gamma_legal_moves(g, player, pick_field, &pick);
+    if (pick.seen == 0) { return FAILED; }
+    return gamma_move(g, player, pick.x, pick.y) ? MOVED : FAILED;
+}
+
+/** @brief Rozgrywa partię i dolicza jej wynik.
+ * Partia kończy się, gdy żaden gracz nie może wykonać ruchu. Wygrywa
+ * gracz, który zajął najwięcej pól, a przy równej liczbie pól jest remis.
+ * @param[in] s - parametry turnieju
+ * @param[in] game - numer partii
+ * @param[in, out] r - wyniki partii rozegranych przez wątek
+ */
+static void play_game(const struct settings *s, uint64_t game,
+                      struct results *r) {
+    gamma_t *g = gamma_new(s->width, s->height, s->players, s->areas);
+    if (g == NULL) {
+        r->failed++;
+        return;
+    }
+    // Stan generatora nie może być zerem.
+    uint64_t random = mix64(s->seed ^ mix64(game)) | 1;
+    uint32_t player = 1;
+    uint32_t passes = 0;
+    while (passes < s->players) {
+        enum turn result = play_turn(g, player, &random);
+        if (result == FAILED) {
+            r->failed++;
+            gamma_delete(g);
+            return;
+        }
+        if (result == MOVED) {
+            passes = 0;
+            r->moves++;
+        } else {
+            passes++;
+        }
+        player = player % s->players + 1;
+    }
+    uint32_t winner = 0;
+    uint64_t best = 0;
+    for (uint32_t p = 1; p <= s->players; p++) {
+        uint64_t busy = gamma_busy_fields(g, p);
+        if (busy > best) {
+            best = busy;
+            winner = p;
+        } else if (busy == best) {
+            winner = 0;
+        }
+    }
+    if (winner == 0) { r->draws++; }
+    else { r->wins[winner - 1]++; }
+    gamma_delete(g);
+}
+
+/** @brief Pobiera numer następnej partii do rozegrania przez wątek.
+ * Jeśli kolejka wątku jest pusta, przenosi do niej połowę kolejki
+ * pierwszego (w kolejności numerów od danego wątku) wątku, który ma
+ * partie czekające na rozegranie. Wątek trzyma naraz co najwyżej jedną
+ * blokadę.
+ * @param[in, out] t - turniej
+ * @param[in] id - numer wątku
+ * @param[out] game - numer partii
+ * @return wartość @p true, jeśli pobrano partię, @p false, jeśli wszystkie
+ * partie zostały już rozdane
+ */
+static bool take_game(struct tournament *t, uint32_t id, uint64_t *game) {
+    struct queue *own = &t->queues[id];
+    pthread_mutex_lock(&own->lock);
+    bool taken = own->next < own->end;
+    if (taken) { *game = own->next++; }
+    pthread_mutex_unlock(&own->lock);
+    if (taken) { return true; }
+
+    uint32_t threads = t->settings.threads;
+    for (uint32_t i = 1; i < threads; i++) {
+        struct queue *victim = &t->queues[(id + i) % threads];
+        pthread_mutex_lock(&victim->lock);
+        uint64_t stolen = (victim->end - victim->next + 1) / 2;
+        uint64_t end = victim->end;
+        victim->end -= stolen;
+        pthread_mutex_unlock(&victim->lock);
+        if (stolen == 0) { continue; }
+        *game = end - stolen;
+        pthread_mutex_lock(&own->lock);
+        own->next = end - stolen + 1;
+        own->end = end;
+        pthread_mutex_unlock(&own->lock);
+        return true;
+    }
+    return false;
+}
+
+/** @brief Rozgrywa partie pobierane przez wątek.
+ * @param[in, out] data - wskaźnik na strukturę @ref worker
+ * @return NULL
+ */
+static void *work(void *data) {
+    struct worker *w = data;
+    uint64_t game;
+    while (take_game(w->tournament, w->id, &game)) {
+        play_game(&w->tournament->settings, game, &w->results);
+    }
+    return NULL;
+}
+
+/** @brief Odczytuje parametr wywołania.
+ * @param[in] argc - liczba parametrów
+ * @param[in] argv - parametry
+ * @param[in] i - numer parametru
+ * @param[in] fallback - wartość parametru, jeśli go nie podano
+ * @param[in] max - największa dopuszczalna wartość parametru
+ * @param[out] value - wartość parametru
+ * @return wartość @p true, jeśli parametr jest liczbą dodatnią
+ * nie większą od @p max lub go nie podano, @p false w przeciwnym wypadku
+ */
+static bool argument(int argc, char *argv[], int i, uint64_t fallback,
+                     uint64_t max, uint64_t *value) {
+    if (i >= argc) {
+        *value = fallback;
+        return true;
+    }
+    char *end;
+    unsigned long long parsed = strtoull(argv[i], &end, 10);
+    *value = parsed;
+    return *argv[i] != '\0' && *end == '\0' && parsed > 0 && parsed <= max;
+}
+
+/** @brief Odczytuje parametry turnieju.
+ * @param[in] argc - liczba parametrów
+ * @param[in] argv - parametry
+ * @param[out] s - parametry turnieju
+ * @return wartość @p true, jeśli parametry są poprawne, @p false
+ * w przeciwnym wypadku
+ */
+static bool read_settings(int argc, char *argv[], struct settings *s) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    uint64_t v[7];
+    bool ok = argc <= 8 &&
+              argument(argc, argv, 1, 1000, UINT64_MAX, &v[0]) &&
+              argument(argc, argv, 2, 10, UINT32_MAX, &v[1]) &&
+              argument(argc, argv, 3, 10, UINT32_MAX, &v[2]) &&
+              argument(argc, argv, 4, 2, UINT32_MAX - 1, &v[3]) &&
+              argument(argc, argv, 5, 3, UINT32_MAX, &v[4]) &&
+              argument(argc, argv, 6, cores > 0 ? cores : 1, 1024, &v[5]) &&
+              argument(argc, argv, 7, 1, UINT64_MAX, &v[6]);
+    *s = (struct settings) {v[0], v[1], v[2], v[3], v[4], v[5], v[6]};
+    return ok;
+}
+
+/** @brief Podaje bieżący czas.
+ * @return liczba sekund od ustalonej chwili
+ */
+static double now() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/** @brief Rozgrywa turniej i wypisuje jego wyniki.
+ * Wyniki wypisywane są w wierszach postaci "klucz wartość".
+ * @param[in] argc - liczba parametrów
+ * @param[in] argv - parametry
+ * @return Zero, jeśli turniej został rozegrany, a w przeciwnym przypadku
+ * kod błędu.
+ */
+int main(int argc, char *argv[]) {
+    struct tournament t;
+    if (!read_settings(argc, argv, &t.settings)) {
+        fprintf(stderr, "usage: %s [games [width [height [players [areas "
+                        "[threads [seed]]]]]]]\n", argv[0]);
+        return 1;
+    }
+    const struct settings *s = &t.settings;
+    t.queues = calloc(s->threads, sizeof(struct queue));
+    struct worker *workers = calloc(s->threads, sizeof(struct worker));
+    if (t.queues == NULL || workers == NULL) { return 1; }
+    for (uint32_t i = 0; i < s->threads; i++) {
+        pthread_mutex_init(&t.queues[i].lock, NULL);
+        t.queues[i].next = s->games * i / s->threads;
+        t.queues[i].end = s->games * (i + 1) / s->threads;
+        workers[i].tournament = &t;
+        workers[i].id = i;
+        workers[i].results.wins = calloc(s->players, sizeof(uint64_t));
+        if (workers[i].results.wins == NULL) { return 1; }
+    }
+
+    double start = now();
+    uint32_t started = 0;
+    while (started < s->threads &&
+           pthread_create(&workers[started].thread, NULL, work,
+                          &workers[started]) == 0) {
+        started++;
+    }
+    // Partie wątków, których nie udało się uruchomić, zostaną podkradzione.
+    if (started == 0) { work(&workers[0]); }
+    for (uint32_t i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    double seconds = now() - start;
+
+    struct results total = {workers[0].results.wins, 0, 0, 0};
+    for (uint32_t i = 0; i < s->threads; i++) {
+        const struct results *r = &workers[i].results;
+        for (uint32_t p = 0; p < s->players && i > 0; p++) {
+            total.wins[p] += r->wins[p];
+        }
+        total.draws += r->draws;
+        total.failed += r->failed;
+        total.moves += r->moves;
+    }
+    uint64_t finished = s->games - total.failed;
+    printf("games %llu\n", (unsigned long long) s->games);
+    printf("failed %llu\n", (unsigned long long) total.failed);
+    printf("threads %u\n", started);
+    printf("seconds %.3f\n", seconds);
+    printf("moves %llu\n", (unsigned long long) total.moves);
+    printf("moves_per_second %.0f\n", total.moves / seconds);
+    printf("games_per_second %.1f\n", finished / seconds);
+    for (uint32_t p = 0; p < s->players; p++) {
+        printf("win_rate %u %.4f\n", p + 1,
+               finished > 0 ? (double) total.wins[p] / finished : 0.0);
+    }
+    printf("draw_rate %.4f\n",
+           finished > 0 ? (double) total.draws / finished : 0.0);
+
+    for (uint32_t i = 0; i < s->threads; i++) {
+        pthread_mutex_destroy(&t.queues[i].lock);
+        free(workers[i].results.wins);
+    }
+    free(workers);
+    free(t.queues);
+    return total.failed == 0 ? 0 : 1;
+}
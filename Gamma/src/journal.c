@@ -0,0 +1,35 @@
+#include "journal.h"
+
+/* Przyjęta przeze mnie początkowa liczba wpisów, na które
+ * rezerwujemy miejsce w dzienniku.
+ */
+const uint64_t init_journal = 64;
+
+Journal new_Journal(const Allocator *allocator) {
+    Journal j;
+    j.entries = NULL;
+    j.size = 0;
+    j.capacity = 0;
+    j.moves = 0;
+    j.failed = false;
+    j.allocator = allocator;
+    return j;
+}
+
+bool grow_Journal(Journal *j) {
+    uint64_t capacity = j->capacity == 0 ? init_journal : 2 * j->capacity;
+    Entry *entries = safe_realloc(j->allocator, j->entries, capacity,
+                                  sizeof(Entry));
+    if (entries == NULL) { return false; }
+    j->entries = entries;
+    j->capacity = capacity;
+    return true;
+}
+
+void del_Journal(Journal *j) {
+    safe_free(j->allocator, j->entries);
+    j->entries = NULL;
+    j->size = 0;
+    j->capacity = 0;
+    j->moves = 0;
+}
@@ -0,0 +1,126 @@
+/** @file
+ * Interfejs dziennika ruchów, pozwalającego cofać ruchy.
+ * Dziennik przechowuje poprzednie wartości wszystkich zmienianych przez
+ * ruch elementów stanu gry: pól planszy, statystyk graczy, liczby wolnych
+ * pól oraz tablic struktury zbiorów rozłącznych (w tym zmian wynikających
+ * z kompresji ścieżek). Po każdym wykonanym ruchu w dzienniku zapisywany
+ * jest znacznik końca ruchu. Cofnięcie ruchu przywraca zapamiętane
+ * wartości w odwrotnej kolejności, więc kosztuje tyle, ile zapisów
+ * wykonał ruch, a nie tyle, ile wynosi rozmiar stanu gry.
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "malloc.h"
+#include <stdint.h>
+
+/**
+ * Rodzaje wpisów w dzienniku - określają, czyją wartość zapamiętano
+ * we wpisie.
+ */
+enum entry_kind {
+    MOVE_END, /**< koniec ruchu, indeks i wartość to kolumna i wiersz pola */
+    CELL, /**< pole planszy o danym numerze */
+    NODE, /**< element, na który wskazuje pole o danym numerze */
+    PARENT, /**< ojciec elementu o danym numerze */
+    RANK, /**< ranga elementu o danym numerze */
+    ELEMENTS, /**< liczba elementów struktury zbiorów rozłącznych */
+    AREAS, /**< liczba obszarów gracza o danym numerze */
+    OCCUPIED, /**< liczba pól zajętych przez gracza o danym numerze */
+    ADJACENT_FREE, /**< liczba wolnych pól przyległych dla gracza */
+    GOLDEN, /**< możliwość wykonania złotego ruchu przez gracza */
+    LAST_PIECE, /**< ostatnie pole gracza na liście zajętych pól */
+    TAKEN, /**< pole zabrane przez gracza złotym ruchem */
+    FREE_FIELDS, /**< liczba wolnych pól na planszy */
+    HASH /**< hasz stanu gry */
+};
+
+/**
+ * Struktura opisująca wpis w dzienniku.
+ */
+struct entry {
+    /*@{*/
+    uint64_t index; /**< numer zmienionego pola, elementu lub gracza */
+    uint64_t value; /**< wartość sprzed zmiany */
+    uint8_t kind; /**< rodzaj wpisu (@ref entry_kind) */
+    /*@{*/
+};
+/**
+ * Typ Entry - alias na struct entry.
+ */
+typedef struct entry Entry;
+
+/**
+ * Struktura przechowująca dziennik ruchów.
+ * Wpisy przechowywane są w tablicy powiększanej dwukrotnie, gdy brakuje
+ * w niej miejsca. Cofnięcie ruchu nie zwalnia pamięci, więc wielokrotne
+ * wykonywanie i cofanie ruchów przestaje w końcu alokować pamięć.
+ */
+struct journal {
+    /*@{*/
+    Entry *entries; /**< wpisy, od najstarszego */
+    uint64_t size; /**< liczba wpisów */
+    uint64_t capacity; /**< liczba wpisów, na które jest miejsce */
+    uint64_t moves; /**< liczba ruchów, które można cofnąć */
+    bool failed; /**< czy nie udało się zapamiętać któregoś wpisu */
+    const Allocator *allocator; /**< alokator pamięci lub NULL */
+    /*@{*/
+};
+/**
+ * Typ Journal - alias na struct journal.
+ */
+typedef struct journal Journal;
+
+/** @brief Tworzy nowy, pusty dziennik ruchów.
+ * Pamięć na wpisy alokowana jest dopiero przy pierwszym wpisie.
+ * @param[in] allocator - alokator pamięci lub NULL (funkcje biblioteki
+ * standardowej), musi istnieć tak długo jak struktura
+ * @return Nowy pusty dziennik.
+ */
+Journal new_Journal(const Allocator *allocator);
+
+/** @brief Usuwa dziennik ruchów.
+ * Zwalnia pamięć zaalokowaną na wpisy.
+ * @param[in, out] j - wskaźnik na dziennik
+ */
+void del_Journal(Journal *j);
+
+/** @brief Powiększa tablicę wpisów dziennika.
+ * Wywoływana przez @ref remember, gdy brakuje miejsca.
+ * @param[in, out] j - wskaźnik na dziennik
+ * @return wartość @p true, jeśli udało się powiększyć tablicę, @p false,
+ * jeśli nie udało się zaalokować pamięci - wtedy dziennik pozostaje
+ * bez zmian.
+ */
+bool grow_Journal(Journal *j);
+
+/** @brief Zapisuje w dzienniku wartość sprzed zmiany.
+ * @param[in, out] j - wskaźnik na dziennik
+ * @param[in] kind - rodzaj wpisu (@ref entry_kind)
+ * @param[in] index - numer zmienianego pola, elementu lub gracza
+ * @param[in] value - wartość sprzed zmiany
+ * Jeśli nie udało się zaalokować pamięci, pomija wpis i zapamiętuje błąd
+ * w polu @p failed.
+ */
+static inline void remember(Journal *j, uint8_t kind, uint64_t index,
+                            uint64_t value) {
+    if (j->size == j->capacity && !grow_Journal(j)) {
+        j->failed = true;
+        return;
+    }
+    Entry *e = &j->entries[j->size++];
+    e->index = index;
+    e->value = value;
+    e->kind = kind;
+}
+
+/** @brief Usuwa wszystkie wpisy, zachowując zaalokowaną pamięć.
+ * @param[in, out] j - wskaźnik na dziennik
+ */
+static inline void clear_Journal(Journal *j) {
+    j->size = 0;
+    j->moves = 0;
+}
+
+#endif //JOURNAL_H
@@ -1,10 +1,40 @@
 #include "malloc.h"
+#include "stats.h"
 
-void *safe_malloc(void *p, size_t s) {
-    p = malloc(s);
-    if (p == NULL) {
-        exit(1);
+/** @brief Sprawdza, czy rozmiar tablicy mieści się w typie size_t.
+ * @param[in] count - liczba elementów tablicy
+ * @param[in] size - rozmiar jednego elementu
+ * @return wartość @p true, jeśli rozmiar tablicy mieści się w typie size_t,
+ * @p false w przeciwnym wypadku
+ */
+static inline bool fits(uint64_t count, size_t size) {
+    return size == 0 || count <= SIZE_MAX / size;
+}
+
+void *safe_malloc(const Allocator *a, uint64_t count, size_t size) {
+    if (!fits(count, size)) { return NULL; }
+    void *result = a == NULL ? malloc(count * size)
+                             : a->allocate(a->data, count * size);
+    if (result != NULL) {
+        COUNT(allocations, 1);
+        COUNT(allocated_bytes, count * size);
+    }
+    return result;
+}
+
+void *safe_realloc(const Allocator *a, void *p, uint64_t count,
+                   size_t size) {
+    if (!fits(count, size)) { return NULL; }
+    void *result = a == NULL ? realloc(p, count * size)
+                             : a->reallocate(a->data, p, count * size);
+    if (result != NULL) {
+        COUNT(allocations, 1);
+        COUNT(allocated_bytes, count * size);
     }
-    return p;
+    return result;
 }
 
+void safe_free(const Allocator *a, void *p) {
+    if (a == NULL) { free(p); }
+    else if (p != NULL) { a->release(a->data, p); }
+}
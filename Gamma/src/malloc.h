@@ -1,21 +1,67 @@
 /** @file
  * Interfejs funkcji odpowiedzialnych za
  * bezpieczną alokację pamięci.
+ * Funkcje nie kończą programu, gdy zabraknie pamięci - zwracają NULL,
+ * a wywołujący zgłasza błąd dalej. Silnik nie ma żadnego wspólnego stanu,
+ * więc różne gry mogą być przetwarzane jednocześnie przez różne wątki.
+ * Pamięć pobierana jest od alokatora gry (patrz @ref Allocator), a jeśli
+ * alokator nie jest podany - od funkcji biblioteki standardowej.
  */
 
 #ifndef MALLOC_H
 #define MALLOC_H
 
+#include <stdbool.h>
 #include <stdlib.h>
 #include <stdint.h>
 
-/** @brief Alokuje daną ilość pamięci na dane miejsce.
- * @param[in, out] p - wskaźnik na miejsce, w którym będziemy trzymać
- * zaalokowaną pamięć
- * @param s - ilosć pamięci do zaalokowania
- * @return - wskaźnik na zaalokowaną pamięć. Kończy program z kodem
- * błędu 1 w przypadku nieudanej alokacji.
+/**
+ * Alokator pamięci: funkcje o znaczeniu funkcji malloc, realloc i free,
+ * którym przekazywane są dodatkowo dane alokatora. Pamięć musi być
+ * wyrównana jak dla funkcji malloc.
  */
-void *safe_malloc(void *p, size_t s);
+struct allocator {
+    /*@{*/
+    void *(*allocate)(void *data, size_t size); /**< alokuje pamięć, zwraca
+                                                 * NULL, jeśli się nie uda */
+    void *(*reallocate)(void *data, void *p,
+                        size_t size); /**< zmienia rozmiar pamięci, jeśli się
+                                       * nie uda, zwraca NULL i nie zmienia
+                                       * pamięci @p p */
+    void (*release)(void *data, void *p); /**< zwalnia pamięć */
+    void *data; /**< dane przekazywane funkcjom alokatora */
+    /*@{*/
+};
+/**
+ * Typ Allocator - alias na strukturę typu allocator.
+ */
+typedef struct allocator Allocator;
+
+/** @brief Alokuje pamięć na tablicę.
+ * @param[in] a - alokator lub NULL (funkcje biblioteki standardowej)
+ * @param[in] count - liczba elementów tablicy
+ * @param[in] size - rozmiar jednego elementu
+ * @return - wskaźnik na zaalokowaną pamięć lub NULL, jeśli rozmiar tablicy
+ * nie mieści się w typie size_t albo nie udało się zaalokować pamięci.
+ */
+void *safe_malloc(const Allocator *a, uint64_t count, size_t size);
+
+/** @brief Zmienia rozmiar zaalokowanej tablicy.
+ * @param[in] a - alokator, którym zaalokowano pamięć @p p
+ * @param[in] p - wskaźnik na zaalokowaną wcześniej pamięć lub NULL
+ * @param[in] count - nowa liczba elementów tablicy
+ * @param[in] size - rozmiar jednego elementu
+ * @return - wskaźnik na pamięć o nowym rozmiarze, zawierającą dotychczasowe
+ * dane, lub NULL, jeśli rozmiar tablicy nie mieści się w typie size_t albo
+ * nie udało się zaalokować pamięci - wtedy pamięć @p p pozostaje
+ * zaalokowana i niezmieniona.
+ */
+void *safe_realloc(const Allocator *a, void *p, uint64_t count, size_t size);
+
+/** @brief Zwalnia pamięć.
+ * @param[in] a - alokator, którym zaalokowano pamięć @p p
+ * @param[in] p - wskaźnik na zaalokowaną wcześniej pamięć lub NULL
+ */
+void safe_free(const Allocator *a, void *p);
 
 #endif //MALLOC_H
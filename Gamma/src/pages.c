@@ -0,0 +1,130 @@
+#include "pages.h"
+#include <string.h>
+
+_Static_assert(sizeof(struct page_header) <= PAGE_HEADER,
+               "nagłówek strony musi się mieścić przed jej elementami");
+
+/** @brief Podaje nagłówek strony.
+ * @param[in] page - strona zaalokowana przez tablicę
+ * @return nagłówek strony
+ */
+static inline struct page_header *header_of(void *page) {
+    return (struct page_header *) ((char *) page - PAGE_HEADER);
+}
+
+/** @brief Alokuje stronę z licznikiem równym 1, bez zerowania elementów.
+ * @param[in] p - tablica
+ * @return nowa strona lub NULL, jeśli nie udało się zaalokować pamięci
+ */
+static void *new_page(const Pages *p) {
+    char *memory = safe_malloc(p->page_allocator, 1,
+                               PAGE_HEADER + PAGE_ELEMENTS * p->element);
+    if (memory == NULL) { return NULL; }
+    void *page = memory + PAGE_HEADER;
+    atomic_init(&header_of(page)->references, 1);
+    return page;
+}
+
+/** @brief Usuwa stronę z tablicy.
+ * Zwalnia stronę, jeśli nie zawiera jej już inna tablica.
+ * @param[in] p - tablica
+ * @param[in] page - strona tablicy lub NULL
+ */
+static void release_page(const Pages *p, void *page) {
+    if (page == NULL || is_borrowed(p, page)) { return; }
+    struct page_header *h = header_of(page);
+    if (atomic_fetch_sub_explicit(&h->references, 1,
+                                  memory_order_acq_rel) == 1) {
+        safe_free(p->page_allocator, h);
+    }
+}
+
+Pages empty_Pages(size_t element, const Allocator *allocator) {
+    Pages p;
+    p.directory = NULL;
+    p.count = 0;
+    p.element = element;
+    p.allocator = allocator;
+    p.page_allocator = allocator;
+    p.borrowed = NULL;
+    p.borrowed_size = 0;
+    return p;
+}
+
+Pages new_Pages(uint64_t elements, size_t element,
+                const Allocator *allocator) {
+    Pages p = empty_Pages(element, allocator);
+    p.count = (elements + PAGE_ELEMENTS - 1) >> PAGE_BITS;
+    p.directory = safe_malloc(allocator, p.count, sizeof(void *));
+    if (p.directory == NULL) { return p; }
+    for (uint64_t i = 0; i < p.count; i++) {
+        p.directory[i] = NULL;
+    }
+    return p;
+}
+
+Pages clone_Pages(const Pages *p, const Allocator *allocator,
+                  const Allocator *page_allocator) {
+    Pages c = *p;
+    c.allocator = allocator;
+    c.page_allocator = page_allocator;
+    c.borrowed = NULL;
+    c.borrowed_size = 0;
+    c.directory = safe_malloc(allocator, c.count, sizeof(void *));
+    if (c.directory == NULL) { return c; }
+    for (uint64_t i = 0; i < c.count; i++) {
+        void *page = p->directory[i];
+        if (page != NULL && is_borrowed(p, page)) {
+            // Strony spoza alokatora mogą zniknąć razem z oryginałem.
+            void *copy = new_page(&c);
+            if (copy == NULL) {
+                for (uint64_t j = i; j < c.count; j++) {
+                    c.directory[j] = NULL;
+                }
+                del_Pages(&c);
+                return c;
+            }
+            memcpy(copy, page, PAGE_ELEMENTS * p->element);
+            page = copy;
+        } else if (page != NULL) {
+            atomic_fetch_add_explicit(&header_of(page)->references, 1,
+                                      memory_order_relaxed);
+        }
+        c.directory[i] = page;
+    }
+    return c;
+}
+
+void del_Pages(Pages *p) {
+    if (p->directory != NULL) {
+        clear_pages(p);
+        safe_free(p->allocator, p->directory);
+    }
+    p->directory = NULL;
+    p->count = 0;
+}
+
+void clear_pages(Pages *p) {
+    for (uint64_t i = 0; i < p->count; i++) {
+        release_page(p, p->directory[i]);
+        p->directory[i] = NULL;
+    }
+}
+
+void *add_page(Pages *p, uint64_t i) {
+    void *page = new_page(p);
+    if (page == NULL) { return NULL; }
+    memset(page, 0, PAGE_ELEMENTS * p->element);
+    p->directory[i >> PAGE_BITS] = page;
+    return page;
+}
+
+void *copy_page(Pages *p, uint64_t i) {
+    void *page = new_page(p);
+    if (page == NULL) { return NULL; }
+    void **slot = &p->directory[i >> PAGE_BITS];
+    memcpy(page, *slot, PAGE_ELEMENTS * p->element);
+    release_page(p, *slot);
+    *slot = page;
+    return page;
+}
@@ -0,0 +1,191 @@
+/** @file
+ * Interfejs klasy przechowującej tablicę podzieloną na strony.
+ * Strony o stałej liczbie elementów alokowane są dopiero przy pierwszym
+ * zapisie do nich, a brakujące strony odczytywane są jako zera. Dzięki
+ * temu ogromna, prawie pusta tablica (pola bardzo dużej planszy) zajmuje
+ * pamięć proporcjonalną tylko do liczby stron, w których coś zapisano,
+ * i do rozmiaru katalogu stron.
+ * Kopia tablicy (patrz @ref clone_Pages) współdzieli strony z oryginałem.
+ * Każda strona ma licznik tablic, które ją zawierają, a tablica przed
+ * zapisem do strony współdzielonej zastępuje ją swoją kopią, więc koszt
+ * kopii tablicy zależy od liczby stron zmienionych potem w którejś z nich.
+ * Strony spoza alokatora (np. z obrazu gry odwzorowanego w pamięci) nie
+ * mają licznika - nie są zwalniane ani współdzielone.
+ */
+
+#ifndef PAGES_H
+#define PAGES_H
+
+#include "malloc.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Logarytm liczby elementów na stronie.
+ */
+#define PAGE_BITS 12
+
+/**
+ * Liczba elementów na stronie.
+ */
+#define PAGE_ELEMENTS ((uint64_t) 1 << PAGE_BITS)
+
+#ifndef PAGING_THRESHOLD
+/**
+ * Tablice pól planszy o większej liczbie elementów są dzielone na strony.
+ * Mniejsze są alokowane w całości, bo dostęp do nich jest szybszy.
+ */
+#define PAGING_THRESHOLD ((uint64_t) 1 << 26)
+#endif
+
+/**
+ * Nagłówek strony, poprzedzający jej elementy.
+ */
+struct page_header {
+    /*@{*/
+    _Atomic uint64_t references; /**< liczba tablic zawierających stronę */
+    /*@{*/
+};
+
+/**
+ * Rozmiar nagłówka strony, zachowujący wyrównanie jej elementów.
+ */
+#define PAGE_HEADER _Alignof(max_align_t)
+
+/**
+ * Struktura przechowująca tablicę podzieloną na strony.
+ */
+struct pages {
+    /*@{*/
+    void **directory; /**< strony tablicy, NULL dla stron niezaalokowanych */
+    uint64_t count; /**< liczba stron */
+    size_t element; /**< rozmiar jednego elementu */
+    const Allocator *allocator; /**< alokator katalogu lub NULL */
+    const Allocator *page_allocator; /**< alokator stron lub NULL - musi być
+                                      * ten sam dla tablicy i jej kopii */
+    const char *borrowed; /**< początek pamięci stron spoza alokatora
+                           * lub NULL */
+    size_t borrowed_size; /**< rozmiar pamięci stron spoza alokatora */
+    /*@{*/
+};
+/**
+ * Typ Pages - alias na struct pages.
+ */
+typedef struct pages Pages;
+
+/** @brief Sprawdza, czy tablicę pól planszy należy podzielić na strony.
+ * @param[in] elements - liczba elementów tablicy
+ * @return wartość @p true, jeśli tablica jest większa od
+ * @ref PAGING_THRESHOLD, @p false w przeciwnym wypadku
+ */
+static inline bool paging(uint64_t elements) {
+    return elements > PAGING_THRESHOLD;
+}
+
+/** @brief Tworzy tablicę bez katalogu stron, niezawierającą elementów.
+ * Służy do oznaczenia, że dane nie są podzielone na strony.
+ * @param[in] element - rozmiar jednego elementu
+ * @param[in] allocator - alokator pamięci lub NULL (funkcje biblioteki
+ * standardowej)
+ * @return Tablica, której pole @p directory ma wartość NULL.
+ */
+Pages empty_Pages(size_t element, const Allocator *allocator);
+
+/** @brief Tworzy tablicę bez żadnej zaalokowanej strony.
+ * Strony alokowane są tym samym alokatorem co katalog, chyba że wywołujący
+ * zmieni pole @p page_allocator przed zapisem pierwszej strony.
+ * @param[in] elements - liczba elementów tablicy
+ * @param[in] element - rozmiar jednego elementu
+ * @param[in] allocator - alokator pamięci lub NULL (funkcje biblioteki
+ * standardowej), musi istnieć tak długo jak struktura
+ * @return Nowa tablica. Jeśli nie udało się zaalokować pamięci, jej pole
+ * @p directory ma wartość NULL.
+ */
+Pages new_Pages(uint64_t elements, size_t element,
+                const Allocator *allocator);
+
+/** @brief Tworzy kopię tablicy, współdzielącą z nią strony.
+ * Strony spoza alokatora są kopiowane od razu.
+ * @param[in] p - tablica
+ * @param[in] allocator - alokator katalogu kopii lub NULL
+ * @param[in] page_allocator - alokator stron kopii, ten sam co tablicy
+ * @p p (może to być jego kopia)
+ * @return Kopia tablicy. Jeśli nie udało się zaalokować pamięci, jej pole
+ * @p directory ma wartość NULL.
+ */
+Pages clone_Pages(const Pages *p, const Allocator *allocator,
+                  const Allocator *page_allocator);
+
+/** @brief Usuwa tablicę.
+ * Zwalnia wszystkie strony, których nie zawiera już inna tablica,
+ * i katalog stron.
+ * @param[in, out] p - tablica
+ */
+void del_Pages(Pages *p);
+
+/** @brief Usuwa wszystkie strony, co zeruje całą tablicę.
+ * Zwalnia strony, których nie zawiera już inna tablica.
+ * @param[in, out] p - tablica
+ */
+void clear_pages(Pages *p);
+
+/** @brief Podaje stronę zawierającą dany element.
+ * @param[in] p - tablica
+ * @param[in] i - numer elementu
+ * @return strona lub NULL, jeśli nie jest zaalokowana
+ */
+static inline void *find_page(const Pages *p, uint64_t i) {
+    return p->directory[i >> PAGE_BITS];
+}
+
+/** @brief Alokuje wyzerowaną stronę zawierającą dany element.
+ * @param[in, out] p - tablica
+ * @param[in] i - numer elementu leżącego na niezaalokowanej stronie
+ * @return nowa strona lub NULL, jeśli nie udało się zaalokować pamięci
+ */
+void *add_page(Pages *p, uint64_t i);
+
+/** @brief Sprawdza, czy strona leży poza pamięcią od alokatora.
+ * @param[in] p - tablica
+ * @param[in] page - zaalokowana strona tablicy
+ * @return wartość @p true, jeśli strona nie ma nagłówka i nie jest
+ * zwalniana, @p false w przeciwnym wypadku
+ */
+static inline bool is_borrowed(const Pages *p, const void *page) {
+    const char *c = page;
+    return p->borrowed != NULL && c >= p->borrowed &&
+           c < p->borrowed + p->borrowed_size;
+}
+
+/** @brief Sprawdza, czy strona jest współdzielona z inną tablicą.
+ * @param[in] p - tablica
+ * @param[in] page - zaalokowana strona tablicy
+ * @return wartość @p true, jeśli stronę zawiera też inna tablica,
+ * @p false w przeciwnym wypadku
+ */
+static inline bool is_shared(const Pages *p, const void *page) {
+    if (is_borrowed(p, page)) { return false; }
+    const struct page_header *h =
+            (const void *) ((const char *) page - PAGE_HEADER);
+    return atomic_load_explicit(&h->references, memory_order_acquire) > 1;
+}
+
+/** @brief Zastępuje współdzieloną stronę jej kopią.
+ * @param[in, out] p - tablica
+ * @param[in] i - numer elementu leżącego na współdzielonej stronie
+ * @return kopia strony lub NULL, jeśli nie udało się zaalokować pamięci -
+ * wtedy tablica się nie zmienia
+ */
+void *copy_page(Pages *p, uint64_t i);
+
+/** @brief Podaje numer elementu na jego stronie.
+ * @param[in] i - numer elementu
+ * @return numer elementu na stronie
+ */
+static inline uint64_t page_offset(uint64_t i) {
+    return i & (PAGE_ELEMENTS - 1);
+}
+
+#endif //PAGES_H
@@ -5,6 +5,8 @@ Player new_Player() {
     p.areas = 0;
     p.occupied = 0;
     p.adjacent_free = 0;
+    p.last = 0;
+    p.taken = 0;
     p.golden = true;
     return p;
 }
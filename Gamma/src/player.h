@@ -23,6 +23,10 @@ struct player{
     uint32_t areas; /**< liczba obszarów gracza */
     uint64_t occupied; /**< liczba pól zajętych przez gracza */
     uint64_t adjacent_free; /**< liczba wolnych pól przyległych dla gracza */
+    uint64_t last; /**< numer (od 1) ostatniego pola gracza na liście
+                    * zajętych pól gry lub 0, jeśli gracz nie zajął pola
+                    * zwykłym ruchem */
+    uint64_t taken; /**< pole zabrane złotym ruchem lub 0 */
     bool golden; /**< możliwość wykonania złotego ruchu */
     /*@{*/
 
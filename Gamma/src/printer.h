@@ -0,0 +1,77 @@
+/** @file
+ * Interfejs zapisu tekstowego opisu pól planszy.
+ * Pole wolne opisuje kropka, pole gracza o numerze jednocyfrowym - ta
+ * cyfra, a numery wielocyfrowe zapisywane są w całości i otoczone
+ * spacjami. Funkcje zapisują tekst do bufora przygotowanego przez
+ * wywołującego, który wcześniej wyznacza potrzebne miejsce za pomocą
+ * @ref number_width.
+ */
+
+#ifndef PRINTER_H
+#define PRINTER_H
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Największa możliwa długość opisu pola: dziesięć cyfr i dwie spacje.
+ */
+#define MAX_NUMBER_WIDTH 12
+
+/**
+ * Opisy pól o wartościach od 0 do 9.
+ */
+extern const char single_digits[10];
+
+/**
+ * Zapisy dziesiętne liczb od 0 do 99, każdy na dwóch znakach.
+ */
+extern const char digit_pairs[200];
+
+/** @brief Wyznacza długość opisu pola.
+ * @param[in] num - wartość pola (0 dla pola wolnego)
+ * @return liczba znaków opisu pola o danej wartości
+ */
+static inline uint64_t number_width(uint32_t num) {
+    if (num < 10) { return 1; }
+    uint64_t digits = 1;
+    while (num >= 10) {
+        num /= 10;
+        digits++;
+    }
+    // Wielocyfrowe numery graczy oddzielamy spacjami.
+    return digits + 2;
+}
+
+/** @brief Zapisuje opis pola.
+ * @param[out] out - miejsce w buforze, od którego zapisujemy opis
+ * (musi zmieścić @ref number_width(@p num) znaków)
+ * @param[in] num - wartość pola (0 dla pola wolnego)
+ * @return wskaźnik na pierwszy znak za zapisanym opisem
+ */
+static inline char *write_number(char *out, uint32_t num) {
+    if (num < 10) {
+        *out = single_digits[num];
+        return out + 1;
+    }
+    uint64_t width = number_width(num);
+    char *end = out + width - 1;
+    out[0] = ' ';
+    *end = ' ';
+    // Cyfry zapisujemy od końca, po dwie naraz.
+    char *digit = end;
+    while (num >= 100) {
+        digit -= 2;
+        memcpy(digit, digit_pairs + 2 * (num % 100), 2);
+        num /= 100;
+    }
+    if (num >= 10) {
+        digit -= 2;
+        memcpy(digit, digit_pairs + 2 * num, 2);
+    } else {
+        *(digit - 1) = single_digits[num];
+    }
+    return end + 1;
+}
+
+#endif // PRINTER_H
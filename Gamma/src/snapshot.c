@@ -0,0 +1,179 @@
+#include "snapshot.h"
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SnapshotWriter new_SnapshotWriter(int fd) {
+    SnapshotWriter w;
+    w.fd = fd;
+    w.offset = 0;
+    w.failed = false;
+    return w;
+}
+
+void write_bytes(SnapshotWriter *w, const void *data, uint64_t size) {
+    w->offset += size;
+    if (w->fd < 0 || w->failed) { return; }
+    const char *buffer = data;
+    while (size > 0) {
+        ssize_t written = write(w->fd, buffer, size);
+        if (written < 0 && errno == EINTR) { continue; }
+        if (written <= 0) {
+            w->failed = true;
+            return;
+        }
+        buffer += written;
+        size -= written;
+    }
+}
+
+/** @brief Dopisuje zera do granicy @ref SNAPSHOT_ALIGNMENT bajtów.
+ * @param[in, out] w - wskaźnik na strukturę
+ */
+static void pad(SnapshotWriter *w) {
+    static const char zeros[SNAPSHOT_ALIGNMENT];
+    uint64_t rest = w->offset % SNAPSHOT_ALIGNMENT;
+    if (rest != 0) { write_bytes(w, zeros, SNAPSHOT_ALIGNMENT - rest); }
+}
+
+uint64_t write_section(SnapshotWriter *w, const void *data, uint64_t size) {
+    pad(w);
+    uint64_t result = w->offset;
+    write_bytes(w, data, size);
+    return result;
+}
+
+uint64_t write_pages(SnapshotWriter *w, const Pages *p) {
+    /* Katalog zapisujemy słowo po słowie, bo przesunięcia stron znamy
+     * z góry - każda strona zajmuje tyle samo miejsca.
+     */
+    pad(w);
+    uint64_t result = w->offset;
+    uint64_t page_size = PAGE_ELEMENTS * p->element;
+    uint64_t next = result + p->count * sizeof(uint64_t);
+    for (uint64_t i = 0; i < p->count; i++) {
+        uint64_t offset = 0;
+        if (p->directory[i] != NULL) {
+            next = (next + SNAPSHOT_ALIGNMENT - 1) / SNAPSHOT_ALIGNMENT *
+                   SNAPSHOT_ALIGNMENT;
+            offset = next;
+            next += page_size;
+        }
+        write_bytes(w, &offset, sizeof(offset));
+    }
+    for (uint64_t i = 0; i < p->count; i++) {
+        if (p->directory[i] != NULL) {
+            write_section(w, p->directory[i], page_size);
+        }
+    }
+    return result;
+}
+
+Mapping new_Mapping(int fd) {
+    Mapping m;
+    memset(&m, 0, sizeof(m));
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 ||
+        (uint64_t) st.st_size > SIZE_MAX) {
+        return m;
+    }
+    void *data = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                      fd, 0);
+    if (data == MAP_FAILED) { return m; }
+    m.data = data;
+    m.size = st.st_size;
+    return m;
+}
+
+void del_Mapping(Mapping *m) {
+    if (m->data != NULL) { munmap(m->data, m->size); }
+    m->data = NULL;
+    m->size = 0;
+}
+
+void *mapped_section(const Mapping *m, uint64_t offset, uint64_t size) {
+    if (offset == 0 || offset % SNAPSHOT_ALIGNMENT != 0 ||
+        offset > m->size || size > m->size - offset) {
+        return NULL;
+    }
+    return m->data + offset;
+}
+
+bool map_pages(const Mapping *m, uint64_t offset, Pages *p) {
+    const uint64_t *directory = mapped_section(m, offset,
+                                               p->count * sizeof(uint64_t));
+    if (directory == NULL) { return false; }
+    p->borrowed = m->data;
+    p->borrowed_size = m->size;
+    for (uint64_t i = 0; i < p->count; i++) {
+        if (directory[i] == 0) { continue; }
+        p->directory[i] = mapped_section(m, directory[i],
+                                         PAGE_ELEMENTS * p->element);
+        if (p->directory[i] == NULL) { return false; }
+    }
+    return true;
+}
+
+/** @brief Sprawdza, czy pamięć leży w odwzorowaniu.
+ * @param[in] m - odwzorowanie
+ * @param[in] p - wskaźnik na pamięć
+ * @return wartość @p true, jeśli @p p wskazuje na odwzorowanie,
+ * @p false w przeciwnym wypadku
+ */
+static inline bool is_mapped(const Mapping *m, const void *p) {
+    const char *c = p;
+    return m->data != NULL && c >= m->data && c < m->data + m->size;
+}
+
+/** @brief Alokuje pamięć spoza odwzorowania.
+ * @param[in] data - wskaźnik na odwzorowanie
+ * @param[in] size - rozmiar pamięci
+ * @return wskaźnik na pamięć lub NULL, jeśli nie udało się jej zaalokować
+ */
+static void *mapping_allocate(void *data, size_t size) {
+    Mapping *m = data;
+    return m->base.allocate(m->base.data, size);
+}
+
+/** @brief Zmienia rozmiar pamięci, kopiując pamięć z odwzorowania.
+ * Rozmiar tablicy z odwzorowania nie jest znany, więc kopiujemy tyle,
+ * ile mieści się w nowej pamięci i w odwzorowaniu - nadmiarowe bajty
+ * nie należą do tablicy, ale ich odczyt jest bezpieczny.
+ * @param[in] data - wskaźnik na odwzorowanie
+ * @param[in] p - wskaźnik na pamięć lub NULL
+ * @param[in] size - nowy rozmiar pamięci
+ * @return wskaźnik na pamięć o nowym rozmiarze lub NULL, jeśli nie udało
+ * się jej zaalokować
+ */
+static void *mapping_reallocate(void *data, void *p, size_t size) {
+    Mapping *m = data;
+    if (!is_mapped(m, p)) {
+        return m->base.reallocate(m->base.data, p, size);
+    }
+    char *result = m->base.allocate(m->base.data, size);
+    if (result == NULL) { return NULL; }
+    size_t rest = m->data + m->size - (char *) p;
+    memcpy(result, p, size < rest ? size : rest);
+    return result;
+}
+
+/** @brief Zwalnia pamięć spoza odwzorowania.
+ * @param[in] data - wskaźnik na odwzorowanie
+ * @param[in] p - wskaźnik na pamięć
+ */
+static void mapping_release(void *data, void *p) {
+    Mapping *m = data;
+    if (!is_mapped(m, p)) { m->base.release(m->base.data, p); }
+}
+
+Allocator mapping_allocator(Mapping *m, Allocator base) {
+    m->base = base;
+    Allocator allocator;
+    allocator.allocate = mapping_allocate;
+    allocator.reallocate = mapping_reallocate;
+    allocator.release = mapping_release;
+    allocator.data = m;
+    return allocator;
+}
@@ -0,0 +1,179 @@
+/** @file
+ * Interfejs binarnego obrazu stanu gry w pliku.
+ * Obraz składa się z nagłówka (patrz @ref snapshot_header) i z sekcji
+ * zawierających surowe tablice struktur gry. Każda sekcja zaczyna się
+ * na granicy @ref SNAPSHOT_ALIGNMENT bajtów, więc po odwzorowaniu pliku
+ * w pamięci (mmap) tablice leżą pod wyrównanymi adresami i gra używa ich
+ * w miejscu, bez kopiowania i bez odtwarzania obszarów. Tablica
+ * podzielona na strony zapisywana jest jako katalog przesunięć stron
+ * w pliku, po którym następują jej zaalokowane strony.
+ * Plik odwzorowywany jest prywatnie: strony zmieniane przez grę system
+ * kopiuje przy pierwszym zapisie, a sam plik się nie zmienia. Pamięć
+ * odwzorowania nie pochodzi od alokatora, więc gra wczytana z pliku
+ * dostaje alokator (patrz @ref mapping_allocator), który jej nie zwalnia,
+ * a tablice z odwzorowania powiększa, kopiując je do nowej pamięci.
+ * Obraz zawiera wartości w kolejności bajtów i w rozmiarach typów
+ * komputera, który go zapisał - nagłówek pozwala sprawdzić, czy pasują.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "malloc.h"
+#include "pages.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Znacznik początku obrazu ("GAMMASNP" w kolejności bajtów little-endian).
+ */
+#define SNAPSHOT_MAGIC UINT64_C(0x504e53414d4d4147)
+
+/**
+ * Wersja formatu obrazu, zmieniana przy każdej zmianie jego postaci.
+ */
+#define SNAPSHOT_VERSION 3
+
+/**
+ * Wyrównanie sekcji obrazu w pliku (rozmiar strony pamięci).
+ */
+#define SNAPSHOT_ALIGNMENT 4096
+
+/**
+ * Nagłówek obrazu stanu gry. Przesunięcia sekcji liczone są od początku
+ * pliku, zero oznacza brak sekcji.
+ */
+struct snapshot_header {
+    /*@{*/
+    uint64_t magic; /**< znacznik @ref SNAPSHOT_MAGIC */
+    uint32_t version; /**< wersja formatu @ref SNAPSHOT_VERSION */
+    uint32_t header_size; /**< rozmiar nagłówka */
+    uint32_t player_size; /**< rozmiar struktury gracza */
+    uint32_t page_bits; /**< logarytm liczby elementów na stronie */
+    uint32_t width; /**< szerokość planszy */
+    uint32_t height; /**< wysokość planszy */
+    uint32_t players; /**< liczba graczy */
+    uint32_t areas; /**< maksymalna liczba obszarów gracza */
+    uint32_t tiled; /**< czy plansza ma układ kafelkowy */
+    uint32_t cell_size; /**< rozmiar pola planszy w bajtach */
+    uint64_t free; /**< liczba wolnych pól */
+    uint64_t hash; /**< hasz Zobrista stanu gry */
+    uint64_t elements; /**< liczba elementów zbiorów rozłącznych */
+    uint64_t player_table; /**< sekcja statystyk graczy */
+    uint64_t cells; /**< sekcja pól planszy (katalog stron dla planszy
+                     * podzielonej na strony) */
+    uint64_t owned; /**< sekcja zbiorów pól graczy małej planszy */
+    uint64_t nodes; /**< sekcja elementów wskazywanych przez pola
+                     * (katalog stron dla planszy podzielonej na strony) */
+    uint64_t parents; /**< sekcja ojców elementów */
+    uint64_t ranks; /**< sekcja rang elementów */
+    uint64_t pieces; /**< sekcja zajętych pól w kolejności zajęcia */
+    uint64_t previous; /**< sekcja poprzednich pól graczy na liście
+                        * zajętych pól */
+    /*@{*/
+};
+
+/**
+ * Struktura zapisująca kolejne sekcje obrazu do pliku. Zapis bez
+ * deskryptora tylko wyznacza przesunięcia sekcji.
+ */
+struct snapshot_writer {
+    /*@{*/
+    int fd; /**< deskryptor pliku lub -1, jeśli dane nie są zapisywane */
+    uint64_t offset; /**< liczba bajtów zapisanych od początku pliku */
+    bool failed; /**< czy zapis się nie powiódł */
+    /*@{*/
+};
+/**
+ * Typ SnapshotWriter - alias na struct snapshot_writer.
+ */
+typedef struct snapshot_writer SnapshotWriter;
+
+/** @brief Tworzy strukturę zapisującą obraz od początku pliku.
+ * @param[in] fd - deskryptor pliku otwartego do zapisu lub -1
+ * @return Nowa struktura.
+ */
+SnapshotWriter new_SnapshotWriter(int fd);
+
+/** @brief Zapisuje dane bez wyrównania.
+ * @param[in, out] w - wskaźnik na strukturę
+ * @param[in] data - dane
+ * @param[in] size - liczba bajtów danych
+ */
+void write_bytes(SnapshotWriter *w, const void *data, uint64_t size);
+
+/** @brief Zapisuje sekcję obrazu, wyrównaną do @ref SNAPSHOT_ALIGNMENT.
+ * @param[in, out] w - wskaźnik na strukturę
+ * @param[in] data - dane sekcji
+ * @param[in] size - liczba bajtów danych
+ * @return przesunięcie sekcji w pliku
+ */
+uint64_t write_section(SnapshotWriter *w, const void *data, uint64_t size);
+
+/** @brief Zapisuje tablicę podzieloną na strony: katalog przesunięć stron
+ * i zaalokowane strony, każdą jako osobną sekcję.
+ * @param[in, out] w - wskaźnik na strukturę
+ * @param[in] p - tablica
+ * @return przesunięcie katalogu w pliku
+ */
+uint64_t write_pages(SnapshotWriter *w, const Pages *p);
+
+/**
+ * Struktura opisująca plik obrazu odwzorowany w pamięci.
+ */
+struct mapping {
+    /*@{*/
+    char *data; /**< początek odwzorowania lub NULL */
+    size_t size; /**< rozmiar odwzorowania */
+    Allocator base; /**< alokator pamięci spoza odwzorowania */
+    /*@{*/
+};
+/**
+ * Typ Mapping - alias na struct mapping.
+ */
+typedef struct mapping Mapping;
+
+/** @brief Odwzorowuje w pamięci cały plik, prywatnie, do odczytu i zapisu.
+ * @param[in] fd - deskryptor pliku otwartego do odczytu
+ * @return Nowe odwzorowanie. Jeśli plik jest pusty lub nie udało się go
+ * odwzorować, jego pole @p data ma wartość NULL.
+ */
+Mapping new_Mapping(int fd);
+
+/** @brief Usuwa odwzorowanie pliku.
+ * Wskaźniki na pamięć odwzorowania stają się nieważne.
+ * @param[in, out] m - wskaźnik na odwzorowanie
+ */
+void del_Mapping(Mapping *m);
+
+/** @brief Podaje sekcję obrazu.
+ * @param[in] m - odwzorowanie
+ * @param[in] offset - przesunięcie sekcji w pliku
+ * @param[in] size - rozmiar sekcji
+ * @return wskaźnik na sekcję w odwzorowaniu lub NULL, jeśli przesunięcie
+ * jest zerem, nie jest wyrównane albo sekcja wychodzi poza plik
+ */
+void *mapped_section(const Mapping *m, uint64_t offset, uint64_t size);
+
+/** @brief Podłącza do tablicy podzielonej na strony strony z odwzorowania.
+ * @param[in] m - odwzorowanie
+ * @param[in] offset - przesunięcie katalogu w pliku
+ * @param[in, out] p - tablica bez zaalokowanych stron
+ * @return wartość @p true, jeśli katalog i wszystkie strony leżą w pliku,
+ * @p false w przeciwnym wypadku
+ */
+bool map_pages(const Mapping *m, uint64_t offset, Pages *p);
+
+/** @brief Tworzy alokator gry korzystającej z odwzorowania.
+ * Pamięci z odwzorowania nie zwalnia, a przy zmianie jej rozmiaru kopiuje
+ * ją do pamięci od alokatora bazowego. Pozostałą pamięć obsługuje
+ * alokator bazowy.
+ * @param[in, out] m - wskaźnik na odwzorowanie, musi istnieć tak długo
+ * jak alokator
+ * @param[in] base - alokator bazowy, zapamiętywany w odwzorowaniu
+ * @return alokator odwzorowania
+ */
+Allocator mapping_allocator(Mapping *m, Allocator base);
+
+#endif //SNAPSHOT_H
@@ -1,53 +1,33 @@
 #include "stack.h"
 
-Pair make_Pair(uint32_t x, uint32_t y) {
-    Pair p;
-    p.x = x;
-    p.y = y;
-    return p;
+/* Przyjęta przeze mnie początkowa liczba elementów, na które
+ * rezerwujemy miejsce na stosie.
+ */
+const uint64_t init_stack = 64;
+
+Stack new_Stack(const Allocator *allocator) {
+    Stack s;
+    s.elements = NULL;
+    s.size = 0;
+    s.capacity = 0;
+    s.failed = false;
+    s.allocator = allocator;
+    return s;
 }
 
-Stack new_Stack() {
-    Stack n = NULL;
-    n = safe_malloc(n, (sizeof(struct stack)));
-    n->next = NULL;
-    return n;
+bool grow_Stack(Stack *s) {
+    uint64_t capacity = s->capacity == 0 ? init_stack : 2 * s->capacity;
+    uint64_t *elements = safe_realloc(s->allocator, s->elements,
+                                      capacity, sizeof(uint64_t));
+    if (elements == NULL) { return false; }
+    s->elements = elements;
+    s->capacity = capacity;
+    return true;
 }
 
-void push(Stack s, Pair p) {
-    if (s == NULL) { exit(2); }
-    Stack n = NULL;
-    n = safe_malloc(n, (sizeof(struct stack)));
-    n->element = p;
-    n->next = s->next;
-    s->next = n;
+void del(Stack *s) {
+    safe_free(s->allocator, s->elements);
+    s->elements = NULL;
+    s->size = 0;
+    s->capacity = 0;
 }
-
-bool empty(Stack s) {
-    if (s == NULL || s->next == NULL) { return true; }
-    return false;
-}
-
-Pair top(Stack s) {
-    if (empty(s)) { exit(2); }
-    return s->next->element;
-}
-
-void pop(Stack s) {
-    if (!empty(s)) {
-        Stack first = s->next;
-        Stack second = first->next;
-        s->next = second;
-        free(first);
-    }
-}
-
-void del(Stack s) {
-    if (s != NULL) {
-        del(s->next);
-        free(s);
-    }
-}
-
-
-
@@ -8,86 +8,87 @@
 #include <stdbool.h>
 
 /**
- * Struktura przechowująca parę współrzędnych pola.
- * Podobnie jak w @ref board.h, współrzędna x opisuje
- * nr wiersza, y - nr kolumny.
- */
-struct pair{
-    /*@{*/
-    uint32_t x; /**< nr wiersza pola */
-    uint32_t y; /**< nr kolumny pola */
-    /*@{*/
-};
-/**
- * Typ Pair - alias na typ struct pair
- */
-typedef struct pair Pair;
-
-/** @brief Zapisuje wspólrzędne pola w struktrze typu Pair.
- * @param[in] x  - nr wiersza pola
- * @param[in] y - nr kolumny pola
- * @return struktura Pair reprezentującą dane pole
- */
-Pair make_Pair(uint32_t x, uint32_t y);
-
-/**
- * Struktura wskaźnikowa reprezentująca stos par.
- * Elementy na stosie będą parami współrzędnych pól,
+ * Struktura reprezentująca stos pól.
+ * Elementy na stosie będą numerami pól planszy (patrz @ref field_index),
  * stos wykorzystwyany będzie przez algorytm DFS.
- * Stos realizowany jest w formie listy z atrapą.
- * z @ref are_connected.
+ * Stos realizowany jest w formie tablicy powiększanej dwukrotnie, gdy
+ * brakuje w niej miejsca. Opróżnienie stosu nie zwalnia pamięci, więc
+ * stos używany wielokrotnie przestaje w końcu alokować pamięć.
  */
 struct stack{
     /*@{*/
-    Pair element; /**< para współrzędnych leżąca na stosie */
-    struct stack *next; /**< wskaźnik na kolejny element stosu,
-                         * leżący pod aktualnym */
+    uint64_t *elements; /**< numery pól leżące na stosie, od spodu */
+    uint64_t size; /**< liczba elementów na stosie */
+    uint64_t capacity; /**< liczba elementów, na które jest miejsce */
+    bool failed; /**< czy nie udało się powiększyć tablicy elementów */
+    const Allocator *allocator; /**< alokator pamięci lub NULL */
     /*@{*/
 };
 /**
- * Typ Stack - wskaźnik na strukture typu stack.
+ * Typ Stack - alias na strukturę typu stack.
  */
-typedef struct stack* Stack;
+typedef struct stack Stack;
 
 /** @brief Tworzy nowy, pusty stos.
- * @return Wskaźnik na nowy stos, kończy program
- * z kodem błędu 1 w przypadku nieudanej alokacji pamięci.
+ * Pamięć na elementy alokowana jest dopiero przy pierwszym
+ * wrzuceniu elementu na stos.
+ * @param[in] allocator - alokator pamięci lub NULL (funkcje biblioteki
+ * standardowej), musi istnieć tak długo jak struktura
+ * @return Nowy pusty stos.
  */
-Stack new_Stack();
+Stack new_Stack(const Allocator *allocator);
 
-/** @brief Kładzie element (typu Pair) na szczycie stosu.
+/** @brief Powiększa tablicę elementów stosu.
+ * Wywoływana przez @ref push, gdy na stosie brakuje miejsca.
  * @param[in, out] s - wskaźnik na stos
- * @param[in] p - struktura typu Pair do wrzucenia na stos.
- * Kończy program z kodem błędu 1 w przypadku nieudanej alokacji
- * pamięci, z kodem 2, jeśli @param[in, out] s jest NULLem.
+ * @return wartość @p true, jeśli udało się powiększyć tablicę, @p false,
+ * jeśli nie udało się zaalokować pamięci - wtedy stos pozostaje bez zmian.
  */
-void push(Stack s, Pair p);
+bool grow_Stack(Stack *s);
+
+/** @brief Kładzie numer pola na szczycie stosu.
+ * Jeśli nie udało się zaalokować pamięci, nie zmienia stosu i zapamiętuje
+ * błąd w polu @p failed - przeszukiwanie korzystające ze stosu jest wtedy
+ * niepełne, ale nie wychodzi poza zaalokowaną pamięć.
+ * @param[in, out] s - wskaźnik na stos
+ * @param[in] f - numer pola do wrzucenia na stos.
+ */
+static inline void push(Stack *s, uint64_t f) {
+    if (s->size == s->capacity && !grow_Stack(s)) {
+        s->failed = true;
+        return;
+    }
+    s->elements[s->size++] = f;
+}
 
 /** @brief Sprawdza, czy dany stos jest pusty.
  * @param[in] s - wskaźnik na stos
- * @return wartość @p true, jeśli stos jest pusty (czyli jest NULLem
- * lub zawiera samą atrapę), @p false w przeciwnym wypadku.
+ * @return wartość @p true, jeśli stos jest pusty, @p false w przeciwnym
+ * wypadku.
  */
-bool empty(Stack s);
+static inline bool empty(const Stack *s) {
+    return s->size == 0;
+}
 
-/** @ brief Zwraca element ze szczytu stosu.
- * @param[in, out] s - wskaźnik na stos
- * @return para liczb znajdująca się na szczycie stosu.
- * Kończy program z kodem błedu 2, jeśli stos @param[in, out] s
- * jest pusty.
+/** @brief Zdejmuje element ze szczytu stosu i go zwraca.
+ * @param[in, out] s - wskaźnik na niepusty stos
+ * @return numer pola, który znajdował się na szczycie stosu.
  */
-Pair top(Stack s);
+static inline uint64_t pop(Stack *s) {
+    return s->elements[--s->size];
+}
 
-/** @brief Zdejmuje element ze szczytu stosu.
- * Nie robi nic, jęsli stos jest pusty.
+/** @brief Opróżnia stos, zachowując zaalokowaną pamięć.
  * @param[in, out] s - wskaźnik na stos
  */
-void pop(Stack s);
+static inline void clear(Stack *s) {
+    s->size = 0;
+}
 
 /** Usuwa stos.
  * Zwalnia pamięć zaalokowaną na ten stos.
- * @param[in, out] s - wskaźnik  na stos.
+ * @param[in, out] s - wskaźnik na stos.
  */
-void del(Stack s);
+void del(Stack *s);
 
 #endif //STACK_H
@@ -0,0 +1,5 @@
+#include "stats.h"
+
+#ifdef GAMMA_STATS
+_Thread_local gamma_stats_t thread_counters;
+#endif
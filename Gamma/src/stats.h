@@ -0,0 +1,95 @@
+/** @file
+ * Liczniki pracy silnika, włączane przy kompilacji.
+ * Liczniki istnieją tylko, gdy zdefiniowane jest makro GAMMA_STATS
+ * (opcja GAMMA_STATS w CMake). W przeciwnym wypadku makro @ref COUNT
+ * nie generuje żadnego kodu, a gra nie przechowuje statystyk.
+ * Moduły silnika nie znają gry, której dotyczy ich praca, więc zwiększają
+ * liczniki bieżącego wątku. Funkcje gry przypisują ich przyrosty
+ * z czasu swojego wywołania grze, na której działały - wątek w danej
+ * chwili wykonuje funkcję tylko jednej gry, więc statystyki różnych gier
+ * przetwarzanych jednocześnie się nie mieszają.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+
+/**
+ * Funkcje gry, których wywołania są zliczane i mierzone.
+ */
+enum gamma_function {
+    GAMMA_STAT_NEW, /**< @ref gamma_new */
+    GAMMA_STAT_MOVE, /**< @ref gamma_move */
+    GAMMA_STAT_GOLDEN_MOVE, /**< @ref gamma_golden_move */
+    GAMMA_STAT_MOVE_BATCH, /**< @ref gamma_move_batch */
+    GAMMA_STAT_BUSY_FIELDS, /**< @ref gamma_busy_fields */
+    GAMMA_STAT_FREE_FIELDS, /**< @ref gamma_free_fields */
+    GAMMA_STAT_GOLDEN_POSSIBLE, /**< @ref gamma_golden_possible */
+    GAMMA_STAT_BOARD, /**< @ref gamma_board */
+    GAMMA_STAT_UNDO, /**< @ref gamma_undo */
+    GAMMA_STAT_LEGAL_MOVES, /**< @ref gamma_legal_moves */
+    GAMMA_STAT_GOLDEN_CANDIDATES, /**< @ref gamma_golden_candidates */
+    GAMMA_STAT_GOLDEN_LEGAL, /**< @ref gamma_golden_legal */
+    GAMMA_STAT_PLAYOUT, /**< @ref gamma_playout */
+    GAMMA_STAT_CLONE, /**< @ref gamma_clone */
+    GAMMA_STAT_FUNCTIONS /**< liczba mierzonych funkcji */
+};
+
+/**
+ * Statystyki pracy silnika dla jednej gry.
+ */
+struct gamma_stats {
+    /*@{*/
+    uint64_t searched_fields; /**< pola odwiedzone przez przeszukiwania
+                               * planszy (podział obszaru, wyznaczanie
+                               * punktów artykulacji) */
+    uint64_t area_splits; /**< podziały obszaru wymagające przeszukania
+                           * planszy */
+    uint64_t allocations; /**< udane alokacje przez safe_malloc
+                           * i safe_realloc, w tym powiększenia stosów */
+    uint64_t allocated_bytes; /**< suma rozmiarów tych alokacji */
+    uint64_t moves_accepted; /**< wykonane zwykłe ruchy */
+    uint64_t moves_rejected; /**< odrzucone zwykłe ruchy */
+    uint64_t golden_accepted; /**< wykonane złote ruchy */
+    uint64_t golden_rejected; /**< odrzucone złote ruchy */
+    uint64_t calls[GAMMA_STAT_FUNCTIONS]; /**< liczba wywołań funkcji */
+    uint64_t ns[GAMMA_STAT_FUNCTIONS]; /**< łączny czas wywołań funkcji
+                                        * w nanosekundach (nie jest
+                                        * mierzony dla funkcji działających
+                                        * w czasie stałym: gamma_busy_fields,
+                                        * gamma_free_fields
+                                        * i gamma_golden_possible) */
+    uint64_t max_ns[GAMMA_STAT_FUNCTIONS]; /**< najdłuższe wywołanie
+                                            * funkcji w nanosekundach
+                                            * (mierzone jak @p ns) */
+    /*@{*/
+};
+/**
+ * Typ gamma_stats_t - alias na struct gamma_stats.
+ */
+typedef struct gamma_stats gamma_stats_t;
+
+#ifdef GAMMA_STATS
+
+/**
+ * Liczniki pracy modułów silnika w bieżącym wątku. Zliczają pracę
+ * wszystkich gier przetwarzanych przez wątek.
+ */
+extern _Thread_local gamma_stats_t thread_counters;
+
+/**
+ * Zwiększa licznik bieżącego wątku.
+ */
+#define COUNT(counter, n) (thread_counters.counter += (n))
+
+#else
+
+/**
+ * Bez GAMMA_STATS liczniki nie istnieją.
+ */
+#define COUNT(counter, n) ((void) 0)
+
+#endif
+
+#endif //STATS_H
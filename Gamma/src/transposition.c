@@ -0,0 +1,43 @@
+#include "transposition.h"
+#include <stdlib.h>
+
+TranspositionTable *new_TranspositionTable(uint64_t entries) {
+    if (entries == 0) { return NULL; }
+    uint64_t size = 1;
+    while (size <= entries / 2) {
+        size *= 2;
+    }
+    if (size > SIZE_MAX / sizeof(struct slot)) { return NULL; }
+    TranspositionTable *t = malloc(sizeof(TranspositionTable));
+    if (t == NULL) { return NULL; }
+    // Wyzerowany wpis pasuje tylko do haszu 0 z wartością 0.
+    t->slots = calloc(size, sizeof(struct slot));
+    if (t->slots == NULL) {
+        free(t);
+        return NULL;
+    }
+    t->mask = size - 1;
+    return t;
+}
+
+void del_TranspositionTable(TranspositionTable *t) {
+    if (t != NULL) {
+        free(t->slots);
+        free(t);
+    }
+}
+
+void store(TranspositionTable *t, uint64_t hash, uint64_t value) {
+    struct slot *s = &t->slots[hash & t->mask];
+    atomic_store_explicit(&s->value, value, memory_order_relaxed);
+    atomic_store_explicit(&s->check, hash ^ value, memory_order_relaxed);
+}
+
+bool probe(TranspositionTable *t, uint64_t hash, uint64_t *value) {
+    struct slot *s = &t->slots[hash & t->mask];
+    uint64_t v = atomic_load_explicit(&s->value, memory_order_relaxed);
+    uint64_t check = atomic_load_explicit(&s->check, memory_order_relaxed);
+    if ((check ^ v) != hash) { return false; }
+    *value = v;
+    return true;
+}
@@ -0,0 +1,74 @@
+/** @file
+ * Interfejs tablicy transpozycji - tablicy o stałym rozmiarze,
+ * przechowującej wartości przypisane stanom gry przez algorytm
+ * przeszukiwania, indeksowanej haszem stanu gry.
+ * Tablica może być współdzielona przez wątki bez blokad: wpis składa się
+ * z wartości i z XOR-a wartości z haszem. Odczyt, który trafił na wpis
+ * zapisany w połowie przez inny wątek, nie zgadza się z haszem i jest
+ * traktowany jak brak wpisu. Nowy wpis zawsze zastępuje poprzedni
+ * w tym samym miejscu tablicy.
+ */
+
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Struktura opisująca wpis tablicy transpozycji.
+ */
+struct slot {
+    /*@{*/
+    _Atomic uint64_t check; /**< XOR haszu stanu i wartości */
+    _Atomic uint64_t value; /**< wartość przypisana stanowi */
+    /*@{*/
+};
+
+/**
+ * Struktura przechowująca tablicę transpozycji.
+ */
+struct transpositionTable {
+    /*@{*/
+    struct slot *slots; /**< wpisy tablicy */
+    uint64_t mask; /**< liczba wpisów pomniejszona o 1 (potęga dwójki) */
+    /*@{*/
+};
+/**
+ * Typ TranspositionTable - alias na struct transpositionTable.
+ */
+typedef struct transpositionTable TranspositionTable;
+
+/** @brief Tworzy pustą tablicę transpozycji.
+ * @param[in] entries - największa dopuszczalna liczba wpisów, dodatnia;
+ * tablica ma tyle wpisów, ile wynosi największa potęga dwójki nie większa
+ * od @p entries
+ * @return Wskaźnik na nową tablicę lub NULL, jeśli nie udało się zaalokować
+ * pamięci lub @p entries jest zerem.
+ */
+TranspositionTable *new_TranspositionTable(uint64_t entries);
+
+/** @brief Usuwa tablicę transpozycji.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in, out] t - wskaźnik na tablicę
+ */
+void del_TranspositionTable(TranspositionTable *t);
+
+/** @brief Zapisuje wartość stanu gry.
+ * @param[in, out] t - wskaźnik na tablicę
+ * @param[in] hash - hasz stanu gry
+ * @param[in] value - wartość
+ */
+void store(TranspositionTable *t, uint64_t hash, uint64_t value);
+
+/** @brief Odczytuje wartość stanu gry.
+ * @param[in] t - wskaźnik na tablicę
+ * @param[in] hash - hasz stanu gry
+ * @param[out] value - odczytana wartość
+ * @return wartość @p true, jeśli tablica zawiera wpis dla danego haszu,
+ * @p false w przeciwnym wypadku
+ */
+bool probe(TranspositionTable *t, uint64_t hash, uint64_t *value);
+
+#endif //TRANSPOSITION_H
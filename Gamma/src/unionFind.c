@@ -0,0 +1,159 @@
+#include "unionFind.h"
+#include <string.h>
+
+/* Przyjęta przeze mnie początkowa liczba elementów, na które
+ * rezerwujemy miejsce. Elementów jest tyle, ile razy powstał nowy
+ * obszar, czyli zwykle dużo mniej niż pól.
+ */
+const uint64_t init_elements = 64;
+
+UnionFind new_bare_UnionFind(uint64_t fields, const Allocator *allocator) {
+    UnionFind u;
+    u.allocator = allocator;
+    u.node = NULL;
+    u.nodes = empty_Pages(sizeof(uint64_t), allocator);
+    if (paging(fields)) {
+        u.nodes = new_Pages(fields, sizeof(uint64_t), allocator);
+    }
+    u.parent = NULL;
+    u.rank = NULL;
+    u.size = 0;
+    u.capacity = 0;
+    u.journal = NULL;
+    u.failed = paging(fields) && u.nodes.directory == NULL;
+    return u;
+}
+
+UnionFind new_UnionFind(uint64_t fields, const Allocator *allocator) {
+    UnionFind u = new_bare_UnionFind(fields, allocator);
+    if (u.failed) { return u; }
+    bool paged = paging(fields);
+    if (!paged) { u.node = safe_malloc(allocator, fields, sizeof(uint64_t)); }
+    u.parent = safe_malloc(allocator, init_elements, sizeof(uint64_t));
+    u.rank = safe_malloc(allocator, init_elements, sizeof(uint8_t));
+    u.capacity = init_elements;
+    if ((!paged && u.node == NULL) || u.parent == NULL || u.rank == NULL) {
+        del_UnionFind(&u);
+        u.failed = true;
+    }
+    return u;
+}
+
+UnionFind clone_UnionFind(const UnionFind *u, uint64_t fields,
+                          const Allocator *allocator,
+                          const Allocator *page_allocator) {
+    UnionFind c = *u;
+    c.allocator = allocator;
+    c.node = NULL;
+    c.nodes = empty_Pages(sizeof(uint64_t), allocator);
+    c.journal = NULL;
+    c.failed = false;
+    if (u->node == NULL) {
+        c.nodes = clone_Pages(&u->nodes, allocator, page_allocator);
+    } else {
+        c.node = safe_malloc(allocator, fields, sizeof(uint64_t));
+    }
+    // Wczytana gra może nie mieć jeszcze miejsca na żaden element.
+    c.capacity = u->capacity > 0 ? u->capacity : init_elements;
+    c.parent = safe_malloc(allocator, c.capacity, sizeof(uint64_t));
+    c.rank = safe_malloc(allocator, c.capacity, sizeof(uint8_t));
+    if ((u->node == NULL ? c.nodes.directory == NULL : c.node == NULL) ||
+        c.parent == NULL || c.rank == NULL) {
+        del_UnionFind(&c);
+        c.failed = true;
+        return c;
+    }
+    if (u->node != NULL) {
+        memcpy(c.node, u->node, fields * sizeof(uint64_t));
+    }
+    if (u->size > 0) {
+        memcpy(c.parent, u->parent, u->size * sizeof(uint64_t));
+        memcpy(c.rank, u->rank, u->size * sizeof(uint8_t));
+    }
+    return c;
+}
+
+/** @brief Powiększa dwukrotnie tablice elementów.
+ * @param[in, out] u - struktura zbiorów rozłącznych
+ * @return wartość @p true, jeśli udało się powiększyć tablice, @p false,
+ * jeśli nie udało się zaalokować pamięci - wtedy liczba elementów, na które
+ * jest miejsce, się nie zmienia.
+ */
+static bool grow_UnionFind(UnionFind *u) {
+    uint64_t capacity = u->capacity > 0 ? 2 * u->capacity : init_elements;
+    uint64_t *parent = safe_realloc(u->allocator, u->parent, capacity,
+                                    sizeof(uint64_t));
+    if (parent == NULL) { return false; }
+    u->parent = parent;
+    uint8_t *rank = safe_realloc(u->allocator, u->rank, capacity,
+                                 sizeof(uint8_t));
+    if (rank == NULL) { return false; }
+    u->rank = rank;
+    u->capacity = capacity;
+    return true;
+}
+
+uint64_t make_set(UnionFind *u) {
+    if (u->size == u->capacity && !grow_UnionFind(u)) {
+        u->failed = true;
+        return NO_SET;
+    }
+    if (u->journal != NULL) {
+        remember(u->journal, ELEMENTS, 0, u->size);
+    }
+    uint64_t v = u->size++;
+    u->parent[v] = v;
+    u->rank[v] = 0;
+    return v;
+}
+
+uint64_t find(UnionFind *u, uint64_t v) {
+    uint64_t root = v;
+    while (u->parent[root] != root) {
+        root = u->parent[root];
+    }
+    // Drugie przejście tej samej ścieżki - kompresja.
+    while (u->parent[v] != root) {
+        uint64_t next = u->parent[v];
+        if (u->journal != NULL) {
+            remember(u->journal, PARENT, v, next);
+        }
+        u->parent[v] = root;
+        v = next;
+    }
+    return root;
+}
+
+uint64_t find_field(UnionFind *u, uint64_t field) {
+    return find(u, node_of(u, field));
+}
+
+bool unite(UnionFind *u, uint64_t a, uint64_t b) {
+    a = find(u, a);
+    b = find(u, b);
+    if (a == b) { return false; }
+    if (u->rank[a] < u->rank[b]) {
+        uint64_t tmp = a;
+        a = b;
+        b = tmp;
+    }
+    if (u->journal != NULL) {
+        remember(u->journal, PARENT, b, b);
+        remember(u->journal, RANK, a, u->rank[a]);
+    }
+    u->parent[b] = a;
+    if (u->rank[a] == u->rank[b]) {
+        u->rank[a]++;
+    }
+    return true;
+}
+
+void del_UnionFind(UnionFind *u) {
+    safe_free(u->allocator, u->node);
+    del_Pages(&u->nodes);
+    safe_free(u->allocator, u->parent);
+    safe_free(u->allocator, u->rank);
+    u->node = NULL;
+    u->parent = NULL;
+    u->rank = NULL;
+}
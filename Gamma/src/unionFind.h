@@ -0,0 +1,189 @@
+/** @file
+ * Interfejs struktury zbiorów rozłącznych (Find-Union), za pomocą
+ * której przechowywane są obszary graczy. Każdy obszar gracza jest
+ * jednym zbiorem. Pola planszy, identyfikowane numerem w tablicy pól
+ * planszy (patrz @ref field_index; numeracja obejmuje ramkę pól
+ * wartowniczych, a w układzie kafelkowym biegnie kafelkami), nie są
+ * elementami struktury bezpośrednio - każde zajęte pole wskazuje
+ * na pewien element, a wiele pól może wskazywać na ten sam.
+ * Dzięki temu obszar, który się rozpadł, można podzielić, przepinając
+ * pola jednej z części na nowy element, bez ruszania pozostałych pól.
+ * Zbiory łączone są według rang, a wyszukiwanie reprezentanta
+ * kompresuje ścieżki, dzięki czemu obie operacje działają
+ * w czasie praktycznie stałym.
+ * Jeśli struktura ma dziennik ruchów, każda zmiana jej tablic (także
+ * przy kompresji ścieżek) jest w nim zapamiętywana, aby można ją było
+ * cofnąć.
+ * Dla bardzo dużych plansz elementy wskazywane przez pola przechowywane
+ * są w tablicy podzielonej na strony (patrz @ref pages.h).
+ */
+
+#ifndef UNIONFIND_H
+#define UNIONFIND_H
+
+#include "journal.h"
+#include "malloc.h"
+#include "pages.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Wartość zwracana przez @ref make_set, gdy nie udało się utworzyć
+ * elementu.
+ */
+#define NO_SET UINT64_MAX
+
+/**
+ * Struktura przechowująca las zbiorów rozłącznych.
+ */
+struct unionFind {
+    /*@{*/
+    uint64_t *node; /**< element, na który wskazuje dane pole, lub NULL,
+                     * jeśli pola są podzielone na strony */
+    Pages nodes; /**< elementy wskazywane przez pola, podzielone na strony
+                  * (katalog stron jest NULL-em, jeśli @p node nim nie jest) */
+    uint64_t *parent; /**< ojciec elementu w drzewie jego zbioru */
+    uint8_t *rank; /**< ranga elementu, ogranicza wysokość jego poddrzewa */
+    uint64_t size; /**< liczba utworzonych elementów */
+    uint64_t capacity; /**< liczba elementów, na które jest miejsce */
+    Journal *journal; /**< dziennik ruchów lub NULL, jeśli zmiany nie są
+                       * zapamiętywane */
+    bool failed; /**< czy nie udało się utworzyć któregoś elementu */
+    const Allocator *allocator; /**< alokator pamięci lub NULL */
+    /*@{*/
+};
+/**
+ * Typ UnionFind - alias na struct unionFind.
+ */
+typedef struct unionFind UnionFind;
+
+/** @brief Tworzy strukturę zbiorów rozłącznych dla planszy o danej
+ * liczbie pól. Początkowo struktura nie zawiera żadnych elementów.
+ * @param[in] fields - liczba pól planszy
+ * @param[in] allocator - alokator pamięci lub NULL (funkcje biblioteki
+ * standardowej), musi istnieć tak długo jak struktura
+ * @return Nowa struktura. Jeśli nie udało się zaalokować pamięci,
+ * jej pole @p failed ma wartość @p true.
+ */
+UnionFind new_UnionFind(uint64_t fields, const Allocator *allocator);
+
+/** @brief Tworzy strukturę zbiorów rozłącznych bez tablic.
+ * Wywołujący podłącza tablice sam (np. z obrazu gry odwzorowanego
+ * w pamięci, patrz @ref snapshot.h). Dla bardzo dużej planszy struktura
+ * dostaje katalog bez żadnej strony.
+ * @param[in] fields - liczba pól planszy
+ * @param[in] allocator - alokator pamięci lub NULL (funkcje biblioteki
+ * standardowej), musi istnieć tak długo jak struktura
+ * @return Nowa struktura. Jeśli nie udało się zaalokować katalogu stron,
+ * jej pole @p failed ma wartość @p true.
+ */
+UnionFind new_bare_UnionFind(uint64_t fields, const Allocator *allocator);
+
+/** @brief Tworzy kopię struktury zbiorów rozłącznych, bez dziennika.
+ * Elementy wskazywane przez pola podzielone na strony kopia współdzieli
+ * z oryginałem (patrz @ref clone_Pages), pozostałe tablice kopiuje.
+ * @param[in] u - struktura zbiorów rozłącznych
+ * @param[in] fields - liczba pól planszy
+ * @param[in] allocator - alokator pamięci kopii lub NULL (funkcje biblioteki
+ * standardowej), musi istnieć tak długo jak kopia
+ * @param[in] page_allocator - alokator stron kopii, ten sam co struktury
+ * @p u
+ * @return Kopia struktury. Jeśli nie udało się zaalokować pamięci,
+ * jej pole @p failed ma wartość @p true.
+ */
+UnionFind clone_UnionFind(const UnionFind *u, uint64_t fields,
+                          const Allocator *allocator,
+                          const Allocator *page_allocator);
+
+/** @brief Podaje element, na który wskazuje dane pole.
+ * @param[in] u - struktura zbiorów rozłącznych
+ * @param[in] field - numer pola
+ * @return numer elementu (dla pola, które nigdy nie było zajęte,
+ * wartość nieokreślona)
+ */
+static inline uint64_t node_of(const UnionFind *u, uint64_t field) {
+    if (u->node != NULL) { return u->node[field]; }
+    const uint64_t *page = find_page(&u->nodes, field);
+    return page != NULL ? page[page_offset(field)] : 0;
+}
+
+/** @brief Zapisuje element, na który wskazuje dane pole, bez zapamiętywania
+ * zmiany w dzienniku.
+ * Jeśli nie uda się zaalokować strony, zapamiętuje błąd w polu @p failed.
+ * @param[in, out] u - struktura zbiorów rozłącznych
+ * @param[in] field - numer pola
+ * @param[in] v - numer elementu
+ */
+static inline void write_node(UnionFind *u, uint64_t field, uint64_t v) {
+    if (u->node != NULL) {
+        u->node[field] = v;
+        return;
+    }
+    uint64_t *page = find_page(&u->nodes, field);
+    if (page == NULL) {
+        page = add_page(&u->nodes, field);
+    } else if (is_shared(&u->nodes, page)) {
+        page = copy_page(&u->nodes, field);
+    }
+    if (page == NULL) {
+        u->failed = true;
+        return;
+    }
+    page[page_offset(field)] = v;
+}
+
+/** @brief Ustawia element, na który wskazuje dane pole.
+ * @param[in, out] u - struktura zbiorów rozłącznych
+ * @param[in] field - numer pola
+ * @param[in] v - numer elementu
+ */
+static inline void set_node(UnionFind *u, uint64_t field, uint64_t v) {
+    if (u->journal != NULL) {
+        remember(u->journal, NODE, field, node_of(u, field));
+    }
+    write_node(u, field, v);
+}
+
+/** @brief Tworzy nowy jednoelementowy zbiór.
+ * Elementy tworzone są kolejno, więc każdy nowy element ma numer
+ * większy od wszystkich dotychczasowych.
+ * @param[in, out] u - struktura zbiorów rozłącznych
+ * @return numer nowego elementu. Jeśli nie udało się zaalokować pamięci,
+ * zapamiętuje błąd w polu @p failed i zwraca @ref NO_SET - wywołujący nie
+ * może wtedy wskazać tej wartości żadnym polem. Struktura nie odpowiada
+ * już obszarom, ale nie wychodzi poza zaalokowaną pamięć.
+ */
+uint64_t make_set(UnionFind *u);
+
+/** @brief Znajduje reprezentanta zbioru, do którego należy dany element.
+ * Po drodze podpina wszystkie odwiedzone elementy bezpośrednio
+ * pod reprezentanta (kompresja ścieżek).
+ * @param[in, out] u - struktura zbiorów rozłącznych
+ * @param[in] v - numer elementu
+ * @return numer reprezentanta zbioru zawierającego @p v
+ */
+uint64_t find(UnionFind *u, uint64_t v);
+
+/** @brief Znajduje reprezentanta zbioru, do którego należy dane pole.
+ * @param[in, out] u - struktura zbiorów rozłącznych
+ * @param[in] field - numer zajętego pola
+ * @return numer reprezentanta zbioru zawierającego pole @p field
+ */
+uint64_t find_field(UnionFind *u, uint64_t field);
+
+/** @brief Łączy zbiory zawierające dane elementy.
+ * @param[in, out] u - struktura zbiorów rozłącznych
+ * @param[in] a - numer pierwszego elementu
+ * @param[in] b - numer drugiego elementu
+ * @return wartość @p true, jeśli elementy należały do różnych zbiorów
+ * (i zostały one połączone), @p false w przeciwnym wypadku.
+ */
+bool unite(UnionFind *u, uint64_t a, uint64_t b);
+
+/** @brief Usuwa strukturę zbiorów rozłącznych.
+ * Zwalnia pamięć zaalokowaną na tę strukturę.
+ * @param[in, out] u - struktura zbiorów rozłącznych
+ */
+void del_UnionFind(UnionFind *u);
+
+#endif //UNIONFIND_H
@@ -0,0 +1,53 @@
+/** @file
+ * Klucze haszowania Zobrista stanu gry.
+ * Hasz stanu gry to XOR kluczy wszystkich zajętych pól (klucz zależy od
+ * współrzędnych pola i jego właściciela) oraz kluczy graczy, którzy nie
+ * wykonali jeszcze złotego ruchu. Ruch zmienia hasz o XOR kilku kluczy,
+ * więc hasz aktualizowany jest w czasie stałym. Klucze nie są losowane
+ * do tablicy, tylko wyliczane funkcją mieszającą splitmix64, dzięki czemu
+ * nie zajmują pamięci proporcjonalnej do rozmiaru planszy i liczby graczy
+ * i są takie same w każdej grze.
+ */
+
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <stdint.h>
+
+/** @brief Miesza bity liczby (funkcja finalizująca splitmix64).
+ * @param[in] z - liczba
+ * @return wynik mieszania
+ */
+static inline uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/** @brief Podaje klucz pola zajętego przez gracza.
+ * @param[in] x - numer kolumny pola
+ * @param[in] y - numer wiersza pola
+ * @param[in] player - nr gracza zajmującego pole
+ * @return klucz pola
+ */
+static inline uint64_t field_key(uint32_t x, uint32_t y, uint32_t player) {
+    return mix64((((uint64_t) y << 32) | x) ^ mix64(player));
+}
+
+/** @brief Podaje klucz gracza, który nie wykonał jeszcze złotego ruchu.
+ * @param[in] player - nr gracza
+ * @return klucz gracza
+ */
+static inline uint64_t golden_key(uint32_t player) {
+    return mix64(mix64(player) ^ 0x9e3779b97f4a7c15ULL);
+}
+
+/** @brief Podaje klucz gracza, na którego ruch czeka gra.
+ * @param[in] player - nr gracza
+ * @return klucz gracza
+ */
+static inline uint64_t turn_key(uint32_t player) {
+    return mix64(mix64(player) ^ 0x3c6ef372fe94f82aULL);
+}
+
+#endif //ZOBRIST_H